@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include "arm_math.h"
+
+// Band watched for activity, around the rest tremor range
+#define ACTIVITY_CENTER_HZ 4.5f
+#define ACTIVITY_Q 1.5f
+// Band RMS over all three axes that starts and ends activity, rad/s (hysteresis)
+#define ACTIVITY_ON_RMS 0.05f
+#define ACTIVITY_OFF_RMS 0.03f
+// Samples per energy block, and quiet blocks in a row before activity ends
+#define ACTIVITY_BLOCK 16
+#define ACTIVITY_HOLD_BLOCKS 8
+
+/**
+ * @brief Cheap tremor-band activity detector for deciding when the full pipeline is worth running.
+ *
+ * One band-pass biquad per axis and a running sum of squares: about 20 multiply-adds per sample. Every
+ * ACTIVITY_BLOCK samples the band RMS is compared with the thresholds; activity starts on the first loud
+ * block and ends after ACTIVITY_HOLD_BLOCKS quiet ones, so a tremor episode with short pauses is captured
+ * as one.
+ */
+class ActivityDetector {
+private:
+    arm_biquad_casd_df1_inst_f32 bandpass[3];
+    float32_t coefs[5];
+    float32_t state[3][4];
+    float32_t sum_squares = 0.0f;
+    uint32_t samples = 0;
+    uint32_t quiet_blocks = 0;
+
+public:
+    // Band RMS of the last block over all axes, rad/s
+    float32_t rms = 0.0f;
+    bool active = false;
+    uint32_t triggers = 0;
+
+    /** CONSTRUCTOR
+     * Designs the band-pass (RBJ, 0 dB peak gain) shared by the three axes.
+     *
+     * @param sample_rate_hz Sampling rate of the stream in hz.
+     *
+     * @returns None
+     */
+    ActivityDetector(float32_t sample_rate_hz) {
+        // CMSIS expects {b0, b1, b2, -a1, -a2} / a0
+        float32_t w0 = 2.0f * PI * ACTIVITY_CENTER_HZ / sample_rate_hz;
+        float32_t alpha = sinf(w0) / (2.0f * ACTIVITY_Q);
+        float32_t a0 = 1.0f + alpha;
+        coefs[0] = alpha / a0;
+        coefs[1] = 0.0f;
+        coefs[2] = -alpha / a0;
+        coefs[3] = 2.0f * cosf(w0) / a0;
+        coefs[4] = -(1.0f - alpha) / a0;
+        for (int axis = 0; axis < 3; axis++) {
+            arm_biquad_cascade_df1_init_f32(&bandpass[axis], 1, coefs, state[axis]);
+        }
+    }
+
+    /**
+     * Processes one sample.
+     *
+     * @param xyz Angular velocity in rad/s.
+     *
+     * @returns True if activity started with this sample, False otherwise.
+     */
+    bool update(const std::array<float, 3>& xyz) {
+        for (int axis = 0; axis < 3; axis++) {
+            float32_t in = xyz[axis];
+            float32_t band;
+            arm_biquad_cascade_df1_f32(&bandpass[axis], &in, &band, 1);
+            sum_squares += band * band;
+        }
+        if (++samples < ACTIVITY_BLOCK)
+            return false;
+
+        arm_sqrt_f32(sum_squares / samples, &rms);
+        sum_squares = 0.0f;
+        samples = 0;
+        if (!active && rms > ACTIVITY_ON_RMS) {
+            active = true;
+            quiet_blocks = 0;
+            triggers++;
+            return true;
+        }
+        if (active) {
+            quiet_blocks = rms < ACTIVITY_OFF_RMS ? quiet_blocks + 1 : 0;
+            if (quiet_blocks >= ACTIVITY_HOLD_BLOCKS)
+                active = false;
+        }
+        return false;
+    }
+};
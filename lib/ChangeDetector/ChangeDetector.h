@@ -0,0 +1,86 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Number of spectrum bins compared (positive half of a 256 point FFT)
+#define CHANGE_MAX_BINS 128
+// Jensen-Shannon distance below which two consecutive spectra count as unchanged
+#define CHANGE_THRESHOLD 0.05f
+// Floor added to every bin (relative to the mean) so the divergence never sees zeros
+#define CHANGE_FLOOR 1e-4f
+
+/**
+ * @brief Detects spectral change between consecutive windows with the Jensen-Shannon distance,
+ *  so classification, logging and drawing can be skipped when nothing changed.
+ *
+ */
+class ChangeDetector {
+private:
+    float32_t spectra[2][CHANGE_MAX_BINS];
+    float32_t *current = spectra[0];
+    float32_t *previous = spectra[1];
+    bool has_previous = false;
+
+public:
+    float32_t last_distance = 0.0f;
+    uint32_t windows = 0;
+    uint32_t skipped = 0;
+
+    /**
+     * Normalizes a magnitude spectrum into a power distribution and compares it with the
+     * previous window.
+     *
+     * @param magnitude Magnitude spectrum.
+     * @param num_bins Number of bins to compare (at most CHANGE_MAX_BINS).
+     *
+     * @returns True if the spectrum changed enough to redo the downstream work, False otherwise.
+     */
+    bool update(const float32_t *magnitude, uint32_t num_bins) {
+        if (num_bins > CHANGE_MAX_BINS)
+            num_bins = CHANGE_MAX_BINS;
+
+        float32_t sum;
+        arm_mult_f32(magnitude, magnitude, current, num_bins);
+        arm_accumulate_f32(current, num_bins, &sum);
+        float32_t floor = (sum > 0.0f ? sum / num_bins : 1.0f) * CHANGE_FLOOR;
+        arm_offset_f32(current, floor, current, num_bins);
+        arm_scale_f32(current, 1.0f / (sum + floor * num_bins), current, num_bins);
+
+        windows++;
+        bool changed = true;
+        if (has_previous) {
+            last_distance = arm_jensenshannon_distance_f32(current, previous, num_bins);
+            changed = last_distance >= CHANGE_THRESHOLD;
+        }
+        if (!changed)
+            skipped++;
+
+        // Compare against the last window that was actually processed, so slow drift still
+        // accumulates into a change instead of being skipped forever
+        if (changed) {
+            float32_t *swap = previous;
+            previous = current;
+            current = swap;
+            has_previous = true;
+        }
+        return changed;
+    }
+
+    /**
+     * Fraction of windows whose downstream work was skipped.
+     *
+     * @returns float skip ratio in [0, 1]
+     */
+    float32_t skipRatio() {
+        return windows == 0 ? 0.0f : static_cast<float32_t>(skipped) / windows;
+    }
+
+    /**
+     * Forgets the reference spectrum, e.g. when switching screens so the next window is drawn.
+     *
+     * @returns None
+     */
+    void reset() {
+        has_previous = false;
+    }
+};
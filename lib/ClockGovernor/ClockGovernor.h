@@ -0,0 +1,172 @@
+#pragma once
+
+#include "mbed.h"
+#include "hal/us_ticker_api.h"
+#include "CycleCounter.h"
+
+/* Core clock levels of the governor */
+enum ClockLevel {
+    CLOCK_LOW,   // HCLK = SYSCLK / 2, while only collecting samples
+    CLOCK_BOOST, // HCLK = SYSCLK, for the FFT / classification burst
+    CLOCK_LEVELS
+};
+
+// FMC refresh counter margin recommended by the reference manual, COUNT = interval * SDCLK - 20
+#define GOVERNOR_SDRAM_REFRESH_MARGIN 20
+
+/**
+ * @brief Switches HCLK between SYSCLK and SYSCLK / 2 with the AHB prescaler, without touching the PLL.
+ *
+ * The APB prescalers are changed in the opposite direction (APB1 /4 -> /2, APB2 /2 -> /1), so PCLK1,
+ * PCLK2 and the APB1 timer clock stay where the startup code put them: SPI5 (gyroscope), USART1
+ * (serial), I2C3 (touch) and the microsecond ticker keep their rates and need no reconfiguration. On the
+ * way down the AHB prescaler is written first, on the way up last, so no APB clock ever exceeds its limit
+ * in between. What does run from HCLK is reconfigured with it:
+ *  | SDRAM (FMC, SDCLK = HCLK / 2): the refresh counter is rescaled, lowered before the clock drops and
+ *    raised after it rises, so the frame buffer is never refreshed too slowly
+ *  | LTDC: the pixel clock comes from PLLSAI and is unchanged; its SDRAM fetches get half the bandwidth
+ *    at CLOCK_LOW, so FIFO underruns are counted
+ * APB2 timers (TIM1, TIM8-11, unused here) run at half speed at CLOCK_LOW. The flash wait states stay
+ * at the 180 MHz setting, which is valid for any lower clock. Deep sleep is locked: waking from stop
+ * mode restores the default clock tree behind the governor's back.
+ */
+class ClockGovernor {
+private:
+    // RCC->CFGR prescaler bits of each level
+    uint32_t cfgr[CLOCK_LEVELS];
+    // FMC refresh count of each level, 0 if the SDRAM is not in use
+    uint32_t refresh_count[CLOCK_LEVELS];
+    uint32_t level_start_us = 0;
+    uint32_t boost_hz = 0;
+    bool enabled = false;
+
+    /**
+     * Reprograms the SDRAM refresh counter, if the SDRAM is in use.
+     *
+     * @returns None
+     */
+    void setRefresh(ClockLevel next) {
+        if (refresh_count[next] != 0)
+            MODIFY_REG(FMC_Bank5_6->SDRTR, FMC_SDRTR_COUNT, refresh_count[next] << FMC_SDRTR_COUNT_Pos);
+    }
+
+public:
+    ClockLevel level = CLOCK_BOOST;
+    // Statistics since init() or clearStats()
+    uint64_t time_us[CLOCK_LEVELS] = {0};
+    uint32_t switches = 0;
+    uint32_t last_switch_cycles = 0;
+    uint32_t worst_switch_cycles = 0;
+    uint64_t total_switch_cycles = 0;
+    uint32_t ltdc_underruns = 0;
+
+    /**
+     * Takes over the clock tree as configured at startup. The governor stays disabled (every level is
+     * the startup clock) unless it finds HCLK = SYSCLK with APB1 /4 and APB2 /2.
+     *
+     * @returns True if enabled, False otherwise.
+     */
+    bool init() {
+        uint32_t current = RCC->CFGR & (RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2);
+        enabled = current == (RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2);
+        cfgr[CLOCK_BOOST] = RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2;
+        cfgr[CLOCK_LOW] = RCC_CFGR_HPRE_DIV2 | RCC_CFGR_PPRE1_DIV2 | RCC_CFGR_PPRE2_DIV1;
+
+        // SDCLK is a fixed fraction of HCLK, so the count for CLOCK_LOW is half the one in use
+        uint32_t count = READ_BIT(FMC_Bank5_6->SDRTR, FMC_SDRTR_COUNT) >> FMC_SDRTR_COUNT_Pos;
+        refresh_count[CLOCK_BOOST] = count;
+        refresh_count[CLOCK_LOW] = count ? (count + GOVERNOR_SDRAM_REFRESH_MARGIN) / 2 - GOVERNOR_SDRAM_REFRESH_MARGIN : 0;
+
+        boost_hz = SystemCoreClock;
+        if (enabled)
+            sleep_manager_lock_deep_sleep();
+        level = CLOCK_BOOST;
+        clearStats();
+        return enabled;
+    }
+
+    /**
+     * Switches to a clock level and measures the switch.
+     *
+     * @returns None
+     */
+    void set(ClockLevel next) {
+        if (!enabled || next == level)
+            return;
+        uint32_t now_us = us_ticker_read();
+        time_us[level] += now_us - level_start_us;
+        level_start_us = now_us;
+
+        core_util_critical_section_enter();
+        uint32_t start = CycleCounter::now();
+        if (next == CLOCK_LOW) {
+            setRefresh(next);
+            // HCLK first, the APB clocks drop below their targets for a moment instead of above
+            MODIFY_REG(RCC->CFGR, RCC_CFGR_HPRE, cfgr[next] & RCC_CFGR_HPRE);
+            MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2, cfgr[next] & (RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2));
+        } else {
+            MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2, cfgr[next] & (RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2));
+            MODIFY_REG(RCC->CFGR, RCC_CFGR_HPRE, cfgr[next] & RCC_CFGR_HPRE);
+            setRefresh(next);
+        }
+        SystemCoreClockUpdate();
+        // Roughly in CLOCK_BOOST cycles, the ones after dropping to CLOCK_LOW take twice as long
+        last_switch_cycles = (CycleCounter::now() - start) << (next == CLOCK_LOW ? 1 : 0);
+        core_util_critical_section_exit();
+
+        if (READ_BIT(LTDC->ISR, LTDC_ISR_FUIF)) {
+            ltdc_underruns++;
+            WRITE_REG(LTDC->ICR, LTDC_ICR_CFUIF);
+        }
+        level = next;
+        switches++;
+        total_switch_cycles += last_switch_cycles;
+        if (last_switch_cycles > worst_switch_cycles)
+            worst_switch_cycles = last_switch_cycles;
+    }
+
+    /**
+     * How many times slower the core runs than at CLOCK_BOOST, as a shift.
+     *
+     * @returns uint32_t 0 at CLOCK_BOOST, 1 at CLOCK_LOW
+     */
+    uint32_t shift() const {
+        return level == CLOCK_LOW ? 1 : 0;
+    }
+
+    /**
+     * Prints the share of time at each level, the switches and their cost over serial.
+     *
+     * @returns None
+     */
+    void printStats() {
+        uint32_t now_us = us_ticker_read();
+        uint64_t spent[CLOCK_LEVELS] = {time_us[CLOCK_LOW], time_us[CLOCK_BOOST]};
+        spent[level] += now_us - level_start_us;
+        uint64_t total = spent[CLOCK_LOW] + spent[CLOCK_BOOST];
+        if (!enabled || total == 0) {
+            printf("Clock: governor disabled, %lu MHz\n", SystemCoreClock / 1000000);
+            return;
+        }
+        uint32_t boost_mhz = boost_hz / 1000000;
+        printf("Clock: %lu MHz %.1f%% (%.2f s), %lu MHz %.1f%% (%.2f s), %lu switches, switch avg %lu worst %lu cycles (%.2f us), ltdc underruns %lu\n",
+               boost_mhz >> 1, 100.0f * spent[CLOCK_LOW] / total, spent[CLOCK_LOW] * 1e-6f,
+               boost_mhz, 100.0f * spent[CLOCK_BOOST] / total, spent[CLOCK_BOOST] * 1e-6f, switches,
+               switches ? static_cast<uint32_t>(total_switch_cycles / switches) : 0, worst_switch_cycles,
+               worst_switch_cycles / static_cast<float>(boost_mhz), ltdc_underruns);
+    }
+
+    /**
+     * Restarts all statistics.
+     *
+     * @returns None
+     */
+    void clearStats() {
+        time_us[CLOCK_LOW] = time_us[CLOCK_BOOST] = 0;
+        level_start_us = us_ticker_read();
+        switches = 0;
+        last_switch_cycles = worst_switch_cycles = 0;
+        total_switch_cycles = 0;
+        ltdc_underruns = 0;
+    }
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+// Hann windowed segments with 50% overlap, transformed while sampling (~1.9 s at 33.3 hz)
+#define COHERENCE_SEGMENT 64
+#define COHERENCE_HOP 32
+// Tremor band kept from every segment spectrum
+#define COHERENCE_LOW_HZ 2.0f
+#define COHERENCE_HIGH_HZ 8.0f
+#define COHERENCE_MAX_BINS 16
+// Magnitude squared coherence above which an axis pair counts as one coherent oscillation
+#define COHERENCE_THRESHOLD 0.7f
+// Axis pairs: x-y, x-z, y-z
+#define COHERENCE_PAIRS 3
+static const uint32_t COHERENCE_PAIR_AXES[COHERENCE_PAIRS][2] = {{0, 1}, {0, 2}, {1, 2}};
+
+/**
+ * @brief Streaming inter-axis cross-spectral analysis: Welch averaged auto and cross spectra of the
+ *  three gyroscope axes over the tremor band, magnitude squared coherence and phase per axis pair.
+ *
+ * Only one segment of history per axis is kept; every hop the x and y segments share one packed
+ * arm_cfft_f32 and z gets a second, the band bins are conjugated (arm_cmplx_conj_f32), multiplied
+ * (arm_cmplx_mult_cmplx_f32) and added to the running sums. Voluntary movement rarely drives all
+ * axes at one frequency with a fixed phase, rest tremor does.
+ */
+class Coherence {
+private:
+    const arm_cfft_instance_f32 *fft = &arm_cfft_sR_f32_len64;
+    float32_t history[3][COHERENCE_SEGMENT] = {{0}};
+    uint32_t head = 0;
+    uint32_t filled = 0;
+    uint32_t hop_count = 0;
+
+    float32_t window[COHERENCE_SEGMENT];
+    float32_t work_xy[COHERENCE_SEGMENT * 2];
+    float32_t work_z[COHERENCE_SEGMENT * 2];
+    float32_t spectrum[3][COHERENCE_MAX_BINS * 2];
+    float32_t conjugate[COHERENCE_MAX_BINS * 2];
+    float32_t product[COHERENCE_MAX_BINS * 2];
+    float32_t power[COHERENCE_MAX_BINS];
+
+    // Running sums of the current window
+    float32_t auto_sum[3][COHERENCE_MAX_BINS] = {{0}};
+    float32_t cross_sum[COHERENCE_PAIRS][COHERENCE_MAX_BINS * 2] = {{0}};
+    uint32_t segments = 0;
+
+    uint32_t first_bin;
+    uint32_t num_bins;
+    float32_t bin_hz;
+
+    void processSegment() {
+        // x + jy in one transform, z alone, oldest sample first
+        for (uint32_t i = 0; i < COHERENCE_SEGMENT; i++) {
+            uint32_t j = (head + i) % COHERENCE_SEGMENT;
+            work_xy[2 * i] = history[0][j] * window[i];
+            work_xy[2 * i + 1] = history[1][j] * window[i];
+            work_z[2 * i] = history[2][j] * window[i];
+            work_z[2 * i + 1] = 0.0f;
+        }
+        arm_cfft_f32(fft, work_xy, 0, 1);
+        arm_cfft_f32(fft, work_z, 0, 1);
+
+        // Separate X and Y: X[k] = (Z[k] + Z*[N-k]) / 2, Y[k] = (Z[k] - Z*[N-k]) / 2j
+        for (uint32_t b = 0; b < num_bins; b++) {
+            uint32_t k = first_bin + b;
+            uint32_t m = COHERENCE_SEGMENT - k;
+            float32_t zr = work_xy[2 * k], zi = work_xy[2 * k + 1];
+            float32_t mr = work_xy[2 * m], mi = work_xy[2 * m + 1];
+            spectrum[0][2 * b] = 0.5f * (zr + mr);
+            spectrum[0][2 * b + 1] = 0.5f * (zi - mi);
+            spectrum[1][2 * b] = 0.5f * (zi + mi);
+            spectrum[1][2 * b + 1] = -0.5f * (zr - mr);
+        }
+        memcpy(spectrum[2], &work_z[2 * first_bin], num_bins * 2 * sizeof(float32_t));
+
+        for (uint32_t a = 0; a < 3; a++) {
+            arm_cmplx_mag_squared_f32(spectrum[a], power, num_bins);
+            arm_add_f32(auto_sum[a], power, auto_sum[a], num_bins);
+        }
+        for (uint32_t p = 0; p < COHERENCE_PAIRS; p++) {
+            arm_cmplx_conj_f32(spectrum[COHERENCE_PAIR_AXES[p][1]], conjugate, num_bins);
+            arm_cmplx_mult_cmplx_f32(spectrum[COHERENCE_PAIR_AXES[p][0]], conjugate, product, num_bins);
+            arm_add_f32(cross_sum[p], product, cross_sum[p], num_bins * 2);
+        }
+        segments++;
+    }
+
+public:
+    // Results of the last completed window, at the strongest band bin of the summed axes
+    float32_t peak_hz = 0.0f;
+    float32_t coherence[COHERENCE_PAIRS] = {0}; // magnitude squared, [0, 1]
+    float32_t phase_deg[COHERENCE_PAIRS] = {0}; // phase of the first axis relative to the second
+    uint32_t window_segments = 0;
+    bool coherent = false;
+
+    /** CONSTRUCTOR
+     * Builds the Hann window and the band bin range.
+     *
+     * @param sample_rate_hz Sampling rate of the axes in hz.
+     *
+     * @returns None
+     */
+    Coherence(float32_t sample_rate_hz) : bin_hz(sample_rate_hz / COHERENCE_SEGMENT) {
+        for (uint32_t i = 0; i < COHERENCE_SEGMENT; i++) {
+            window[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / COHERENCE_SEGMENT);
+        }
+        first_bin = static_cast<uint32_t>(ceilf(COHERENCE_LOW_HZ / bin_hz));
+        uint32_t last_bin = static_cast<uint32_t>(floorf(COHERENCE_HIGH_HZ / bin_hz));
+        if (first_bin < 1)
+            first_bin = 1;
+        if (last_bin > COHERENCE_SEGMENT / 2 - 1)
+            last_bin = COHERENCE_SEGMENT / 2 - 1;
+        num_bins = last_bin - first_bin + 1;
+        if (num_bins > COHERENCE_MAX_BINS)
+            num_bins = COHERENCE_MAX_BINS;
+    }
+
+    /**
+     * Appends one sample of each axis, processing a segment every COHERENCE_HOP samples once the
+     * history is full.
+     *
+     * @returns True if a segment was processed, False otherwise.
+     */
+    bool update(float32_t x, float32_t y, float32_t z) {
+        history[0][head] = x;
+        history[1][head] = y;
+        history[2][head] = z;
+        head = (head + 1) % COHERENCE_SEGMENT;
+        if (filled < COHERENCE_SEGMENT)
+            filled++;
+        if (++hop_count < COHERENCE_HOP || filled < COHERENCE_SEGMENT)
+            return false;
+        hop_count = 0;
+        processSegment();
+        return true;
+    }
+
+    /**
+     * Forgets the segment history, for a stream that resumes after a gap. Spectra accumulated in the
+     * current window are kept.
+     *
+     * @returns None
+     */
+    void reset() {
+        head = 0;
+        filled = 0;
+        hop_count = 0;
+    }
+
+    /**
+     * Computes coherence and phase from the accumulated spectra and starts a new window. The segment
+     * history carries over, call reset() first if the next window does not continue this one. With a single
+     * segment coherence is trivially 1, so at least two are required for a coherent decision.
+     *
+     * @returns True if an axis pair oscillates coherently at the band peak, False otherwise.
+     */
+    bool endWindow() {
+        window_segments = segments;
+        coherent = false;
+        if (segments > 0) {
+            uint32_t peak = 0;
+            float32_t peak_power = 0.0f;
+            for (uint32_t b = 0; b < num_bins; b++) {
+                float32_t total = auto_sum[0][b] + auto_sum[1][b] + auto_sum[2][b];
+                if (total > peak_power) {
+                    peak_power = total;
+                    peak = b;
+                }
+            }
+            peak_hz = (first_bin + peak) * bin_hz;
+
+            for (uint32_t p = 0; p < COHERENCE_PAIRS; p++) {
+                float32_t re = cross_sum[p][2 * peak], im = cross_sum[p][2 * peak + 1];
+                float32_t den = auto_sum[COHERENCE_PAIR_AXES[p][0]][peak] * auto_sum[COHERENCE_PAIR_AXES[p][1]][peak];
+                coherence[p] = den > 0.0f ? (re * re + im * im) / den : 0.0f;
+                float32_t angle;
+                arm_atan2_f32(im, re, &angle);
+                phase_deg[p] = angle * 57.295779513f;
+                if (segments >= 2 && coherence[p] >= COHERENCE_THRESHOLD)
+                    coherent = true;
+            }
+        }
+
+        memset(auto_sum, 0, sizeof(auto_sum));
+        memset(cross_sum, 0, sizeof(cross_sum));
+        segments = 0;
+        return coherent;
+    }
+};
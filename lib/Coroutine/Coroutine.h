@@ -0,0 +1,256 @@
+#pragma once
+
+#include <coroutine>
+#include "mbed.h"
+
+// Coroutines that can exist at once, and the static frame slot each one gets. The frames of the
+// main.cpp tasks, built for 32 bit with GCC 12 -std=gnu++20 -fcoroutines (same size from -O0 to -Os):
+// dspTask 300 bytes (256 of them its sample block), uiTask 32, touchPollTask 24, drawTask 24
+#define COROUTINE_MAX_TASKS 4
+#define COROUTINE_FRAME_SIZE 768
+// Coroutines that can wait on one event at the same time
+#define COROUTINE_MAX_WAITERS 4
+
+/**
+ * @brief Fixed pool of coroutine frames, so no coroutine ever touches the heap.
+ *
+ * The compiler asks for the frame size when a coroutine is created; a request that is too large or
+ * finds no free slot fails, and the task comes back invalid instead of allocating.
+ */
+class CoFramePool {
+private:
+    alignas(8) inline static uint8_t storage[COROUTINE_MAX_TASKS][COROUTINE_FRAME_SIZE];
+
+public:
+    // Bytes requested by the coroutine in each slot, 0 if the slot is free
+    inline static uint32_t frame_size[COROUTINE_MAX_TASKS] = {0};
+    inline static uint32_t failures = 0;
+
+    static void *allocate(size_t size) noexcept {
+        if (size <= COROUTINE_FRAME_SIZE) {
+            for (uint32_t i = 0; i < COROUTINE_MAX_TASKS; i++) {
+                if (frame_size[i] == 0) {
+                    frame_size[i] = size;
+                    return storage[i];
+                }
+            }
+        }
+        failures++;
+        return nullptr;
+    }
+
+    static void release(void *frame) noexcept {
+        for (uint32_t i = 0; i < COROUTINE_MAX_TASKS; i++) {
+            if (frame == storage[i])
+                frame_size[i] = 0;
+        }
+    }
+};
+
+/**
+ * @brief Handle of a coroutine that returns nothing. It starts suspended and is run by CoRuntime.
+ */
+class CoTask {
+public:
+    struct promise_type {
+        static void *operator new(size_t size) noexcept {
+            return CoFramePool::allocate(size);
+        }
+        static void operator delete(void *frame) noexcept {
+            CoFramePool::release(frame);
+        }
+        static CoTask get_return_object_on_allocation_failure() noexcept {
+            return CoTask(nullptr);
+        }
+        CoTask get_return_object() noexcept {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit CoTask(std::coroutine_handle<promise_type> _handle) : handle(_handle) {}
+    CoTask(CoTask &&other) noexcept : handle(other.handle) {
+        other.handle = nullptr;
+    }
+    CoTask(const CoTask &) = delete;
+    ~CoTask() {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool valid() const {
+        return static_cast<bool>(handle);
+    }
+};
+
+/**
+ * @brief Something a coroutine can co_await: next sample block, touch, frame tick, ...
+ *
+ * notify() only sets a flag and is safe from interrupts. The flag stays set until CoRuntime finds a
+ * waiter, which it then resumes together with every other waiter, so a notification that arrives
+ * while the consumer is still busy is not lost. Several notifications before the resume count as one.
+ */
+class CoEvent {
+private:
+    std::coroutine_handle<> waiters[COROUTINE_MAX_WAITERS];
+    uint32_t num_waiters = 0;
+    volatile bool pending = false;
+
+public:
+    // Every event links itself into one list, scanned by CoRuntime
+    inline static CoEvent *first = nullptr;
+    CoEvent *next;
+    const char *name;
+    uint32_t resumes = 0;
+
+    /** CONSTRUCTOR
+     *
+     * @param _name Name used in the statistics.
+     *
+     * @returns None
+     */
+    CoEvent(const char *_name) : next(first), name(_name) {
+        first = this;
+    }
+
+    /**
+     * Wakes the coroutines waiting on this event at the runtime's next pass. Safe from interrupts.
+     *
+     * @returns None
+     */
+    void notify() {
+        pending = true;
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> waiter) noexcept {
+        MBED_ASSERT(num_waiters < COROUTINE_MAX_WAITERS);
+        waiters[num_waiters++] = waiter;
+    }
+
+    void await_resume() const noexcept {}
+
+    /**
+     * True if notified and someone is waiting.
+     *
+     * @returns bool
+     */
+    bool ready() const {
+        return pending && num_waiters > 0;
+    }
+
+    /**
+     * Resumes all waiters if notified. Waiters that await again while being resumed wait for the next
+     * notification.
+     *
+     * @returns True if any coroutine ran, False otherwise.
+     */
+    bool dispatch() {
+        if (!ready())
+            return false;
+        std::coroutine_handle<> resuming[COROUTINE_MAX_WAITERS];
+        uint32_t count = num_waiters;
+        for (uint32_t i = 0; i < count; i++) {
+            resuming[i] = waiters[i];
+        }
+        num_waiters = 0;
+        pending = false;
+        for (uint32_t i = 0; i < count; i++) {
+            resuming[i].resume();
+        }
+        resumes += count;
+        return true;
+    }
+};
+
+/**
+ * @brief Single stack, run-to-completion coroutine runtime: resumes coroutines whose event fired and
+ *  sleeps (WFI) when none did. Only the interrupt handlers that notify events run outside of it.
+ */
+class CoRuntime {
+private:
+    std::coroutine_handle<> tasks[COROUTINE_MAX_TASKS];
+    uint32_t num_tasks = 0;
+
+public:
+    uint32_t passes = 0;
+    uint32_t sleeps = 0;
+
+    /**
+     * Takes over a coroutine and runs it up to its first co_await.
+     *
+     * @returns True if started, False if its frame could not be allocated or the table is full.
+     */
+    bool spawn(CoTask &&task) {
+        if (!task.valid() || num_tasks >= COROUTINE_MAX_TASKS)
+            return false;
+        tasks[num_tasks++] = task.handle;
+        task.handle = nullptr;
+        tasks[num_tasks - 1].resume();
+        return true;
+    }
+
+    /**
+     * Resumes the waiters of every notified event once.
+     *
+     * @returns True if any coroutine ran, False otherwise.
+     */
+    bool poll() {
+        bool ran = false;
+        for (CoEvent *event = CoEvent::first; event != nullptr; event = event->next) {
+            ran = event->dispatch() || ran;
+        }
+        passes++;
+        return ran;
+    }
+
+    /**
+     * Runs the coroutines forever. The ready check and the sleep share one critical section, so a
+     * notification from an interrupt in between still wakes the core.
+     *
+     * @returns None, never returns
+     */
+    void run() {
+        while (true) {
+            if (poll())
+                continue;
+            core_util_critical_section_enter();
+            bool ready = false;
+            for (CoEvent *event = CoEvent::first; event != nullptr; event = event->next) {
+                ready = ready || event->ready();
+            }
+            if (!ready) {
+                sleep_manager_sleep_auto();
+                sleeps++;
+            }
+            core_util_critical_section_exit();
+        }
+    }
+
+    /**
+     * Prints the frame bytes of every coroutine and how often each event resumed one.
+     *
+     * @returns None
+     */
+    void printStats() {
+        printf("Coroutines: %lu tasks, frames", num_tasks);
+        for (uint32_t i = 0; i < COROUTINE_MAX_TASKS; i++) {
+            printf(" %lu", CoFramePool::frame_size[i]);
+        }
+        printf(" of %d bytes (%d static), allocation failures %lu\n", COROUTINE_FRAME_SIZE,
+               COROUTINE_MAX_TASKS * COROUTINE_FRAME_SIZE, CoFramePool::failures);
+        printf("Coroutines: %lu passes, %lu sleeps, resumes", passes, sleeps);
+        for (CoEvent *event = CoEvent::first; event != nullptr; event = event->next) {
+            printf(" %s %lu", event->name, event->resumes);
+        }
+        printf("\n");
+    }
+};
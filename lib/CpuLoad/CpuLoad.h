@@ -0,0 +1,109 @@
+#pragma once
+
+#include "mbed.h"
+#include "DeadlineMonitor.h"
+
+// Length of one utilization measurement
+#ifndef CPU_LOAD_PERIOD_MS
+#define CPU_LOAD_PERIOD_MS 1000
+#endif
+
+/**
+ * @brief CPU utilization per period from the sleep manager's idle accounting, split by pipeline stage.
+ *
+ * Every profile idles through sleep_manager_sleep_auto(): the RTOS idle thread, Scheduler::dispatch(),
+ * CoRuntime::run() and thread_sleep_for() in the bare-metal loop. With platform.cpu-stats-enabled the
+ * sleep manager accumulates the time spent asleep (mbed_stats_cpu_get()), so busy time is wall time
+ * minus idle time without any hook of our own. The stage split comes from the cycles DeadlineMonitor
+ * charges to every begin()/end() stage; a stage is charged to the period in which it ends, busy time
+ * outside all stages (interrupts, serial output, touch) is reported as other.
+ */
+class CpuLoad {
+private:
+    DeadlineMonitor &monitor;
+    mbed_stats_cpu_t previous = {};
+    uint32_t previous_busy[DEADLINE_MAX_STAGES] = {0};
+    us_timestamp_t total_us = 0;
+    us_timestamp_t total_busy_us = 0;
+
+public:
+    // Last completed period, in percent of wall time
+    float utilization = 0;
+    float stage_load[DEADLINE_MAX_STAGES] = {0};
+    float other_load = 0;
+    // Highest period and average since start(), in percent
+    float peak = 0;
+    float average = 0;
+    uint32_t periods = 0;
+
+    /** CONSTRUCTOR
+     *
+     * @param _monitor Monitor whose bracketed stages make up the split.
+     *
+     * @returns None
+     */
+    CpuLoad(DeadlineMonitor &_monitor) : monitor(_monitor) {}
+
+    /**
+     * Starts the first period now.
+     *
+     * @returns None
+     */
+    void start() {
+        mbed_stats_cpu_get(&previous);
+        for (uint32_t i = 0; i < DEADLINE_MAX_STAGES; i++) {
+            previous_busy[i] = monitor.stages[i].busy;
+        }
+    }
+
+    /**
+     * Closes the current period once CPU_LOAD_PERIOD_MS have passed. Cheap enough to call on every
+     * sample or UI poll.
+     *
+     * @returns True if a period was completed and the results were updated, False otherwise.
+     */
+    bool update() {
+        mbed_stats_cpu_t now;
+        mbed_stats_cpu_get(&now);
+        us_timestamp_t elapsed = now.uptime - previous.uptime;
+        if (elapsed < CPU_LOAD_PERIOD_MS * 1000ULL)
+            return false;
+        us_timestamp_t idle = now.idle_time - previous.idle_time;
+        us_timestamp_t busy = idle < elapsed ? elapsed - idle : 0;
+        utilization = 100.0f * busy / elapsed;
+
+        const float cycles_to_percent = 100.0f / (elapsed * (monitor.clock_hz / 1000000));
+        other_load = utilization;
+        for (uint32_t i = 0; i < DEADLINE_MAX_STAGES; i++) {
+            uint32_t cycles = monitor.stages[i].busy;
+            stage_load[i] = (cycles - previous_busy[i]) * cycles_to_percent;
+            other_load -= stage_load[i];
+            previous_busy[i] = cycles;
+        }
+        if (other_load < 0)
+            other_load = 0;
+
+        total_us += elapsed;
+        total_busy_us += busy;
+        average = 100.0f * total_busy_us / total_us;
+        if (utilization > peak)
+            peak = utilization;
+        periods++;
+        previous = now;
+        return true;
+    }
+
+    /**
+     * Prints the last period: utilization, peak and average, then the share of every named stage.
+     *
+     * @returns None
+     */
+    void print() {
+        printf("Load: %5.1f%% (peak %5.1f%% avg %5.1f%%)", utilization, peak, average);
+        for (uint32_t i = 0; i < DEADLINE_MAX_STAGES; i++) {
+            if (monitor.stages[i].busy != 0)
+                printf(" %s %.1f%%", monitor.stages[i].name, stage_load[i]);
+        }
+        printf(" other %.1f%%\n", other_load);
+    }
+};
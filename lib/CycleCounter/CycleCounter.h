@@ -0,0 +1,78 @@
+#pragma once
+
+#include "mbed.h"
+
+/**
+ * @brief Measures code sections in CPU cycles using the Cortex-M4 DWT cycle counter
+ *
+ */
+class CycleCounter {
+private:
+    uint32_t start_cycles = 0;
+
+public:
+    uint32_t last = 0;
+    uint32_t worst = 0;
+    uint32_t count = 0;
+    uint64_t total = 0;
+
+    /**
+     * Enables the DWT cycle counter. Safe to call more than once.
+     *
+     * @returns None
+     */
+    static void enable() {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    /**
+     * Reads the free running cycle counter.
+     *
+     * @returns uint32_t current cycle count
+     */
+    static uint32_t now() {
+        return DWT->CYCCNT;
+    }
+
+    /**
+     * Marks the start of a measured section.
+     *
+     * @returns None
+     */
+    void start() {
+        start_cycles = DWT->CYCCNT;
+    }
+
+    /**
+     * Marks the end of a measured section and updates the statistics.
+     *
+     * @returns uint32_t cycles spent since start()
+     */
+    uint32_t stop() {
+        last = DWT->CYCCNT - start_cycles;
+        if (last > worst)
+            worst = last;
+        total += last;
+        count++;
+        return last;
+    }
+
+    /**
+     * Average cycles per measured section.
+     *
+     * @returns uint32_t average cycle count
+     */
+    uint32_t average() {
+        if (count == 0)
+            return 0;
+        return static_cast<uint32_t>(total / count);
+    }
+
+    void clear() {
+        last = 0;
+        worst = 0;
+        count = 0;
+        total = 0;
+    }
+};
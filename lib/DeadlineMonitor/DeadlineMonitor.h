@@ -0,0 +1,158 @@
+#pragma once
+
+#include "mbed.h"
+#include "CycleCounter.h"
+
+// Stages a monitor can track
+#define DEADLINE_MAX_STAGES 8
+
+/**
+ * @brief Budget and miss statistics of one pipeline stage, in CPU cycles
+ *
+ */
+struct StageDeadline {
+    const char *name = "";
+    uint32_t budget = 0;
+    uint32_t start = 0;
+    uint32_t last = 0;
+    uint32_t worst = 0;
+    uint32_t count = 0;
+    uint32_t misses = 0;
+    uint32_t worst_lateness = 0;
+    // Cycles spent in the stage so far, wraps (bracketed stages only)
+    uint32_t busy = 0;
+};
+
+/**
+ * @brief Checks pipeline stages against their cycle budgets on the DWT cycle counter.
+ *
+ * A stage is either bracketed with begin()/end() (run time against the budget) or marked with
+ * period() once per activation (time since the previous activation against the budget, e.g. the
+ * sampling interval, so anything that delays a read shows up as lateness there). Both only read
+ * CYCCNT, subtract and compare; overhead() measures the actual cost. Every stage must only be used
+ * from one context at a time; the counter wraps after 2^32 cycles (~24 s at 180 MHz).
+ *
+ * Budgets and reports refer to the core clock at setBudget(). While the core runs slower by a power of
+ * two, clock_shift scales the measured cycles back to that clock; a stage is scaled by the clock it ends at.
+ */
+class DeadlineMonitor {
+public:
+    StageDeadline stages[DEADLINE_MAX_STAGES];
+    // Core clock the budgets were set at, and the current clock as a right shift of it
+    uint32_t clock_hz = SystemCoreClock;
+    uint32_t clock_shift = 0;
+
+    /**
+     * Names a stage and sets its budget.
+     *
+     * @param id Stage index, below DEADLINE_MAX_STAGES.
+     * @param name Name used in reports.
+     * @param budget_us Budget in microseconds, converted with the current core clock.
+     *
+     * @returns None
+     */
+    void setBudget(uint32_t id, const char *name, uint32_t budget_us) {
+        clock_hz = SystemCoreClock;
+        stages[id].name = name;
+        stages[id].budget = budget_us * (clock_hz / 1000000);
+    }
+
+    /**
+     * Marks the start of a bracketed stage.
+     *
+     * @returns None
+     */
+    inline void begin(uint32_t id) {
+        stages[id].start = CycleCounter::now();
+    }
+
+    /**
+     * Marks the end of a bracketed stage and checks it against its budget.
+     *
+     * @returns uint32_t cycles the stage took
+     */
+    inline uint32_t end(uint32_t id) {
+        StageDeadline &s = stages[id];
+        uint32_t elapsed = (CycleCounter::now() - s.start) << clock_shift;
+        s.busy += elapsed;
+        record(s, elapsed);
+        return elapsed;
+    }
+
+    /**
+     * Marks one activation of a periodic stage and checks the time since the previous one. The first
+     * activation only starts the clock.
+     *
+     * @returns None
+     */
+    inline void period(uint32_t id) {
+        StageDeadline &s = stages[id];
+        uint32_t now = CycleCounter::now();
+        if (s.start != 0)
+            record(s, (now - s.start) << clock_shift);
+        s.start = now;
+    }
+
+    /**
+     * Restarts a periodic stage, e.g. after sampling was stopped on purpose.
+     *
+     * @returns None
+     */
+    void restart(uint32_t id) {
+        stages[id].start = 0;
+    }
+
+    /**
+     * Updates the statistics of a stage with one measurement.
+     *
+     * @returns None
+     */
+    inline void record(StageDeadline &s, uint32_t elapsed) {
+        s.last = elapsed;
+        s.count++;
+        if (elapsed > s.worst)
+            s.worst = elapsed;
+        if (elapsed > s.budget) {
+            s.misses++;
+            if (elapsed - s.budget > s.worst_lateness)
+                s.worst_lateness = elapsed - s.budget;
+        }
+    }
+
+    /**
+     * Measures the cycles one begin()/end() pair adds, on a scratch stage.
+     *
+     * @returns uint32_t cycles
+     */
+    uint32_t overhead() {
+        StageDeadline saved = stages[DEADLINE_MAX_STAGES - 1];
+        uint32_t best = UINT32_MAX;
+        for (int i = 0; i < 8; i++) {
+            uint32_t start = CycleCounter::now();
+            begin(DEADLINE_MAX_STAGES - 1);
+            end(DEADLINE_MAX_STAGES - 1);
+            uint32_t cost = CycleCounter::now() - start;
+            if (cost < best)
+                best = cost;
+        }
+        stages[DEADLINE_MAX_STAGES - 1] = saved;
+        return best;
+    }
+
+    /**
+     * Prints every named stage: last and worst time, budget, misses and worst lateness in microseconds.
+     *
+     * @returns None
+     */
+    void print() {
+        const float us_per_cycle = 1e6f / clock_hz;
+        for (uint32_t i = 0; i < DEADLINE_MAX_STAGES; i++) {
+            const StageDeadline &s = stages[i];
+            if (s.budget == 0)
+                continue;
+            printf("Deadline: %-9s last %8.0f us worst %8.0f us budget %8.0f us misses %lu/%lu worst late %8.0f us\n",
+                   s.name, s.last * us_per_cycle, s.worst * us_per_cycle, s.budget * us_per_cycle, s.misses, s.count,
+                   s.worst_lateness * us_per_cycle);
+        }
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Length of the magnitude spectrum (full, two-sided)
+#define FUNDAMENTAL_SIZE 256
+// Fundamental search range
+#define FUNDAMENTAL_LOW_HZ 2.5f
+#define FUNDAMENTAL_HIGH_HZ 8.5f
+// Harmonics multiplied into the product spectrum (those above nyquist count as floor)
+#define FUNDAMENTAL_HARMONICS 3
+// Floor relative to the spectral peak, so empty bins cannot drive the product to minus infinity
+#define FUNDAMENTAL_FLOOR 0.02f
+// The octave up candidate wins unless the lower one scores this much better (log ratio, ~10 dB)
+#define FUNDAMENTAL_OCTAVE_MARGIN 1.1f
+
+/**
+ * @brief Fundamental frequency of a magnitude spectrum via the harmonic product spectrum.
+ *
+ * The spectrum is floored and converted to log magnitude once (arm_vlog_f32); the product over
+ * harmonics then becomes a sum, score(k) = L[k] + L[2k] + L[3k], with a +-(h - 1) bin tolerance on
+ * harmonic h. A fundamental that is weaker than its second harmonic still wins as long as it is
+ * above the floor, which is exactly the case where arm_max_f32 reports twice the tremor frequency.
+ * Harmonicity is the share of the tremor range energy carried by the detected harmonic series.
+ * No extra transform is needed: the cost is one vector log and ~FUNDAMENTAL_HARMONICS compares per
+ * candidate bin.
+ */
+class FundamentalEstimator {
+private:
+    float32_t log_spectrum[FUNDAMENTAL_SIZE / 2];
+    float32_t score[FUNDAMENTAL_SIZE / 2];
+    float32_t bin_hz;
+    uint32_t first_bin;
+    uint32_t last_bin;
+
+    /**
+     * Largest log magnitude within +-width bins of k, floor beyond nyquist.
+     *
+     * @returns float log magnitude
+     */
+    float32_t harmonicLevel(uint32_t k, uint32_t width, float32_t floor_level) {
+        if (k + width >= FUNDAMENTAL_SIZE / 2)
+            return floor_level;
+        float32_t level = log_spectrum[k - width];
+        for (uint32_t j = k - width + 1; j <= k + width; j++) {
+            if (log_spectrum[j] > level)
+                level = log_spectrum[j];
+        }
+        return level;
+    }
+
+public:
+    // Results of the last estimate
+    float32_t f0 = 0.0f;          // hz
+    float32_t harmonicity = 0.0f; // [0, 1]
+    uint32_t harmonics_found = 0; // harmonics above the floor, including the fundamental
+
+    /** CONSTRUCTOR
+     *
+     * @param sample_rate_hz Sampling rate of the windowed signal in hz.
+     *
+     * @returns None
+     */
+    FundamentalEstimator(float32_t sample_rate_hz) : bin_hz(sample_rate_hz / FUNDAMENTAL_SIZE) {
+        first_bin = static_cast<uint32_t>(ceilf(FUNDAMENTAL_LOW_HZ / bin_hz));
+        last_bin = static_cast<uint32_t>(floorf(FUNDAMENTAL_HIGH_HZ / bin_hz));
+        if (first_bin < 2)
+            first_bin = 2;
+    }
+
+    /**
+     * Estimates the fundamental of a two-sided magnitude spectrum (e.g. the output of arm_cmplx_mag_f32).
+     *
+     * @param magnitude FUNDAMENTAL_SIZE magnitudes, bin k at k * fs / FUNDAMENTAL_SIZE.
+     *
+     * @returns float fundamental frequency in hz
+     */
+    float32_t estimate(const float32_t *magnitude) {
+        const uint32_t half = FUNDAMENTAL_SIZE / 2;
+
+        // Floor relative to the strongest bin above the fundamental range's lower edge (ignores drift at DC)
+        float32_t peak_value;
+        uint32_t peak_index;
+        arm_max_f32(magnitude + first_bin, half - first_bin, &peak_value, &peak_index);
+        const float32_t floor_value = FUNDAMENTAL_FLOOR * peak_value + 1e-12f;
+        for (uint32_t k = 0; k < half; k++) {
+            log_spectrum[k] = magnitude[k] > floor_value ? magnitude[k] : floor_value;
+        }
+        arm_vlog_f32(log_spectrum, log_spectrum, half);
+        const float32_t floor_level = logf(floor_value);
+
+        // Product spectrum in the log domain
+        uint32_t best = first_bin;
+        for (uint32_t k = first_bin; k <= last_bin; k++) {
+            float32_t s = log_spectrum[k];
+            for (uint32_t h = 2; h <= FUNDAMENTAL_HARMONICS; h++) {
+                s += harmonicLevel(h * k, h - 1, floor_level);
+            }
+            score[k] = s;
+            if (s > score[best])
+                best = k;
+        }
+        // A lone sinusoid scores the same at f and f / 2; prefer the octave up unless clearly worse
+        while (2 * best <= last_bin && score[2 * best] >= score[best] - FUNDAMENTAL_OCTAVE_MARGIN) {
+            best = 2 * best;
+        }
+
+        // Interpolated frequency of the fundamental bin
+        float32_t l = magnitude[best - 1], c = magnitude[best], r = magnitude[best + 1];
+        float32_t den = l - 2.0f * c + r;
+        float32_t offset = den < 0.0f ? 0.5f * (l - r) / den : 0.0f;
+        offset = offset > 0.5f ? 0.5f : (offset < -0.5f ? -0.5f : offset);
+        f0 = (best + offset) * bin_hz;
+
+        // Share of the energy from the lower search edge to nyquist that sits on the harmonic series
+        float32_t total = 0.0f;
+        for (uint32_t k = first_bin - 1; k < half; k++) {
+            total += magnitude[k] * magnitude[k];
+        }
+        float32_t on_series = 0.0f;
+        harmonics_found = 0;
+        for (uint32_t h = 1; h <= FUNDAMENTAL_HARMONICS && h * best + h < half; h++) {
+            uint32_t centre = h * best;
+            bool above_floor = false;
+            for (uint32_t j = centre - h; j <= centre + h; j++) {
+                on_series += magnitude[j] * magnitude[j];
+                above_floor = above_floor || magnitude[j] > floor_value;
+            }
+            if (above_floor)
+                harmonics_found++;
+        }
+        harmonicity = total > 0.0f ? on_series / total : 0.0f;
+        return f0;
+    }
+};
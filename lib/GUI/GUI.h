@@ -4,14 +4,31 @@
 #include <string>
 // Mbed
 #include "mbed.h"
+#include "hal/us_ticker_api.h"
 #include "LCD_DISCO_F429ZI.h"
 #include "TS_DISCO_F429ZI.h"
 // Project
 #include "Region.h"
+#include "RingBuffer.h"
 
 #define SCREEN_XSIZE 240
 #define SCREEN_YSIZE 320
 
+// Interrupt output of the STMPE811 touch controller (active low)
+#define TOUCH_INT_PIN PA_15
+// Touches queued until GUI::update() handles them
+#define TOUCH_QUEUE_SIZE 8
+
+/**
+ * @brief A new touch, timestamped when the touch controller raised its interrupt
+ *
+ */
+struct TouchEvent {
+    uint32_t timestamp_us;
+    uint16_t x;
+    uint16_t y;
+};
+
 /** 
  * @brief Represents an action that can be performed in a GUI, along with UI
  * 
@@ -38,10 +55,48 @@ public:
  * 
  */
 class GUI {
+private:
+    InterruptIn touch_int;
+    volatile bool touch_irq = false;
+    volatile uint32_t touch_irq_us = 0;
+    bool touch_down = false;
+
+    /**
+     * Touch controller interrupt: only remembers when it fired, the I2C read happens in serviceTouch().
+     *
+     * @returns None
+     */
+    void touchISR(void) {
+        if (!touch_irq)
+            touch_irq_us = us_ticker_read();
+        touch_irq = true;
+        touch_interrupts++;
+    }
+
+    /**
+     * Maps a raw STMPE811 sample to screen coordinates with the corrections of BSP_TS_GetState(),
+     * without its smoothing against the previous position.
+     *
+     * @returns None
+     */
+    static void mapRawTouch(uint16_t raw_x, uint16_t raw_y, uint16_t &x, uint16_t &y) {
+        int32_t yr = (static_cast<int32_t>(raw_y) - 360) / 11;
+        y = yr <= 0 ? 0 : (yr > SCREEN_YSIZE ? SCREEN_YSIZE - 1 : yr);
+        int32_t xr = (raw_x <= 3000 ? 3870 - static_cast<int32_t>(raw_x) : 3800 - static_cast<int32_t>(raw_x)) / 15;
+        x = xr <= 0 ? 0 : (xr > SCREEN_XSIZE ? SCREEN_XSIZE - 1 : xr);
+    }
+
 public:
     LCD_DISCO_F429ZI lcd;
     TS_DISCO_F429ZI ts; 
 
+    // New touches in order, filled by serviceTouch() and consumed by update()
+    RingBuffer<TouchEvent, TOUCH_QUEUE_SIZE> touch_events;
+    uint32_t touch_interrupts = 0;
+    uint32_t touch_reads = 0;
+    // Time from the controller interrupt to update() handling the last touch
+    uint32_t touch_latency_us = 0;
+
     TS_StateTypeDef TS_State;
     uint16_t touch_x = 0;
     uint16_t touch_y = 0;
@@ -61,13 +116,16 @@ public:
      *
      * @returns None
      */
-    GUI(string _title) :  title(_title), backButton(54, 30, 44, 24, LCD_COLOR_DARKGREEN, LCD_COLOR_DARKYELLOW, 4, LCD_COLOR_DARKYELLOW, "BACK") {
+    GUI(string _title) : touch_int(TOUCH_INT_PIN, PullUp), title(_title), backButton(54, 30, 44, 24, LCD_COLOR_DARKGREEN, LCD_COLOR_DARKYELLOW, 4, LCD_COLOR_DARKYELLOW, "BACK") {
         // Initialize LCD
         lcd.Init();
         lcd.Clear(background_color);
         BSP_LCD_SetFont(&Font24);
         // Initialize Touchscreen
         printf("%d\n", ts.Init(SCREEN_XSIZE, SCREEN_YSIZE));
+        // Touch detect and FIFO threshold interrupts instead of polling over I2C
+        ts.ITConfig();
+        touch_int.fall(callback(this, &GUI::touchISR));
     }
 
     /**
@@ -119,23 +177,54 @@ public:
     }
 
     /**
-     * Polls the touchscreen for the last touch coordinates and determines
-     * if this is a new touch event.
+     * Reads the touch controller if its interrupt fired since the last call and queues a TouchEvent when
+     * a new touch started. Cheap enough to call once per sample, no I2C traffic without an interrupt.
+     *
+     * The controller keeps the samples of a touch in its FIFO, so a tap that was already released when
+     * this runs is still queued, at the position of its first sample. The FIFO is emptied on every call.
+     *
+     * @returns None
+     */
+    void serviceTouch(void) {
+        if (!touch_irq)
+            return;
+        core_util_critical_section_enter();
+        uint32_t timestamp_us = touch_irq_us;
+        touch_irq = false;
+        core_util_critical_section_exit();
+
+        // Clear before reading, so a change after the read raises a new interrupt
+        ts.ITClear();
+        touch_reads++;
+        uint8_t queued = IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_FIFO_SIZE);
+        bool pressed = (IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_TSC_CTRL) & STMPE811_TS_CTRL_STATUS) != 0;
+        if (queued > 0 && !touch_down) {
+            // Oldest sample, read through the non-incrementing data register
+            uint8_t data[4];
+            IOE_ReadMultiple(TS_I2C_ADDRESS, STMPE811_REG_TSC_DATA_NON_INC, data, sizeof(data));
+            uint32_t xyz = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+            mapRawTouch((xyz >> 20) & 0xFFF, (xyz >> 8) & 0xFFF, TS_State.X, TS_State.Y);
+            TouchEvent event;
+            event.timestamp_us = timestamp_us;
+            event.x = TS_State.X;
+            event.y = SCREEN_YSIZE - TS_State.Y;
+            touch_events.push(event);
+        }
+        // A press without samples yet is picked up by the FIFO threshold interrupt that follows
+        touch_down = pressed && (touch_down || queued > 0);
+        TS_State.TouchDetected = touch_down;
+        IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_FIFO_STA, 0x01);
+        IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_FIFO_STA, 0x00);
+    }
+
+    /**
+     * Services the touch controller and reports whether a new touch is waiting.
      *
      * @returns bool
      */
     bool getTouchEvent(void) {
-        // Get touchscreen state
-        ts.GetState(&TS_State);
-
-        // If coordinates are different, this is a new touch event
-        if (TS_State.X != touch_x && (SCREEN_YSIZE - TS_State.Y) != touch_y) {
-            touch_x = TS_State.X;
-            touch_y = SCREEN_YSIZE - TS_State.Y;
-            return true;
-        }
-        else
-            return false;
+        serviceTouch();
+        return !touch_events.empty();
     }
 
     /**
@@ -144,8 +233,18 @@ public:
      * @returns None
      */
     void update(void) {
+        // Oldest queued touch, if any
+        TouchEvent event;
+        bool touched = touch_events.pop(event);
+        if (touched) {
+            touch_x = event.x;
+            touch_y = event.y;
+            touch_latency_us = us_ticker_read() - event.timestamp_us;
+        }
+
         // On MAIN menu screen
-        printf("state: %d\n", state);
+        printf("state: %d touch latency %lu us (%lu interrupts, %lu reads, %lu dropped)\n", state, touch_latency_us,
+               touch_interrupts, touch_reads, touch_events.overruns());
         if (state == -1) {
             // Draw Main Title
             drawTitle();
@@ -155,7 +254,7 @@ public:
                 it->button->draw(&lcd);
 
                 // If touching a menu option, start the corresponding action
-                if (TS_State.TouchDetected && it->button->isWithin(touch_x, touch_y)) {
+                if (touched && it->button->isWithin(touch_x, touch_y)) {
                     // Show Touch
                     it->button->fill(&lcd);
                     thread_sleep_for(500);
@@ -183,7 +282,7 @@ public:
             backButton.draw(&lcd);
 
             // Check if we can go back to menu state
-            if (TS_State.TouchDetected && backButton.isWithin(touch_x, touch_y)) {
+            if (touched && backButton.isWithin(touch_x, touch_y)) {
                 // Show touch
                 backButton.fill(&lcd);
                 thread_sleep_for(500);
@@ -1,5 +1,6 @@
 #include <array>
 #include "mbed.h"
+#include "hal/us_ticker_api.h"
 
 // Gyroscope SPI pins
 #define GYRO_MOSI PF_9
@@ -14,12 +15,42 @@
 #define CTRL_REG1 0x20
 // Configuration: 200Hz ODR,50Hz cutoff, Power on, Z on, Y on, X on
 #define CTRL_REG1_CONFIG 0b01'10'1'1'1'1
+// FIFO configuration: 95Hz ODR, 12.5Hz cutoff, Power on, Z on, Y on, X on
+#define CTRL_REG1_FIFO_CONFIG 0b00'00'1'1'1'1
+#define GYRO_FIFO_ODR_HZ 95
+// FIFO capture configuration: 190Hz ODR, 12.5Hz cutoff, Power on, Z on, Y on, X on
+#define CTRL_REG1_FIFO_FAST_CONFIG 0b01'00'1'1'1'1
+#define GYRO_FIFO_FAST_ODR_HZ 190
+
+// Register fields(bits): I1_Int1(1), I1_Boot(1), H_Lactive(1), PP_OD(1), I2_DRDY(1), I2_WTM(1), I2_ORun(1), I2_Empty(1)
+#define CTRL_REG3 0x22
+// FIFO configuration: FIFO watermark on INT2, active high, push-pull
+#define CTRL_REG3_FIFO_CONFIG 0b0'0'0'0'0'1'0'0
 
 // Register fields(bits): reserved(1), endian-ness(1), Full scale sel(2), reserved(1), self-test(2), SPI mode(1)
 #define CTRL_REG4 0x23
 // Configuration: reserved, little endian, 500 dps, reserved, disabled, 4-wire mode
 #define CTRL_REG4_CONFIG 0b0'0'01'0'00'0
 
+// Register fields(bits): BOOT(1), FIFO_EN(1), reserved(1), HPen(1), INT1_Sel(2), Out_Sel(2)
+#define CTRL_REG5 0x24
+// FIFO configuration: FIFO enabled, no high-pass
+#define CTRL_REG5_FIFO_CONFIG 0b0'1'0'0'00'00
+
+// Register fields(bits): FIFO mode(3), watermark level(5)
+#define FIFO_CTRL_REG 0x2E
+#define FIFO_MODE_BYPASS 0b000'00000
+#define FIFO_MODE_STREAM 0b010'00000
+// Register fields(bits): WTM(1), OVRN(1), EMPTY(1), stored samples(5)
+#define FIFO_SRC_REG 0x2F
+#define FIFO_SRC_OVRN 0b0'1'0'00000
+#define FIFO_SRC_EMPTY 0b0'0'1'00000
+#define FIFO_SRC_FSS 0b0'0'0'11111
+// Samples the FIFO holds, 6 bytes each
+#define GYRO_FIFO_DEPTH 32
+// L3GD20 INT2 (DRDY/FIFO interrupt) on the Discovery board
+#define GYRO_INT2_PIN PA_2
+
 // Read/write buffer for SPI
 #define BUFFER_SIZE 32
 // Conversion to Degrees per second
@@ -49,8 +80,45 @@ private:
     SPI spi;
     uint8_t write_buf[BUFFER_SIZE]; 
     uint8_t read_buf[BUFFER_SIZE];
+    // Command byte and up to a full FIFO of samples
+    uint8_t fifo_buf[1 + 6 * GYRO_FIFO_DEPTH];
+    uint8_t fifo_watermark = 0;
+    uint32_t last_fifo_us = 0;
+    bool fifo_started = false;
+
+    /**
+     * Runs one SPI transfer and waits for it.
+     *
+     * @returns None
+     */
+    void transfer(const uint8_t *tx, int tx_length, uint8_t *rx, int rx_length) {
+        spi.transfer(tx, tx_length, rx, rx_length, GYRO_SPI_CB, SPI_EVENT_COMPLETE);
+        GYRO_FLAGS.wait_all(SPI_FLAG);
+    }
+
+    /**
+     * Converts one little endian X, Y, Z sample to rad/s.
+     *
+     * @returns An array of floats containing the X, Y, and Z values.
+     */
+    static std::array<float, 3> decode(const uint8_t *data) {
+        std::array<float, 3> output_xyz;
+        for (int axis = 0; axis < 3; axis++) {
+            int16_t raw = (((uint16_t)data[2 * axis + 1]) << 8) | ((uint16_t)data[2 * axis]);
+            output_xyz[axis] = ((float)raw)*(SCALING_FACTOR);
+        }
+        return output_xyz;
+    }
     
 public:
+    // Microsecond hardware ticker value at the start of the last sequential_read() or readFifo() (wraps every ~71 min)
+    uint32_t timestamp_us = 0;
+    // FIFO sample period measured from the reads, starts at the nominal ODR
+    float fifo_period_us = 1e6f / GYRO_FIFO_ODR_HZ;
+    uint32_t fifo_reads = 0;
+    uint32_t fifo_samples = 0;
+    uint32_t fifo_overruns = 0;
+
     /** Default Constructor
      * Initializes the gyroscope sensor.
      *
@@ -71,47 +139,166 @@ public:
 
         // Configuration of Gyroscope
         //configuration: 200Hz ODR, 50Hz cutoff, Power on, Z on, Y on, X on
-        write_buf[0] = CTRL_REG1;
-        write_buf[1] = CTRL_REG1_CONFIG;
-        spi.transfer(write_buf, 2, read_buf, 2, GYRO_SPI_CB, SPI_EVENT_COMPLETE );
-        GYRO_FLAGS.wait_all(SPI_FLAG);
+        writeRegister(CTRL_REG1, CTRL_REG1_CONFIG);
 
         //configuration: reserved, little endian, 500 dps, reserved, disabled, 4-wire mode
-        write_buf[0] = CTRL_REG4;
-        write_buf[1] = CTRL_REG4_CONFIG;
-        spi.transfer(write_buf, 2, read_buf, 2, GYRO_SPI_CB, SPI_EVENT_COMPLETE );
-        GYRO_FLAGS.wait_all(SPI_FLAG); 
+        writeRegister(CTRL_REG4, CTRL_REG4_CONFIG);
     }
 
     /**
-     * Reads the current X, Y, and Z values from the sensor sequentially.
+     * Reads the current X, Y, and Z values from the sensor sequentially and timestamps the read.
      *
      * @returns An array of floats containing the X, Y, and Z values.
      */
     std::array<float, 3> sequential_read() {
-        int16_t raw_x, raw_y, raw_z;
-        std::array<float, 3> output_xyz;
+        startRead(GYRO_SPI_CB);
+        GYRO_FLAGS.wait_all(SPI_FLAG);
+        return readResult();
+    }
 
+    /**
+     * Timestamps and starts a sequential read of X, Y and Z without waiting for it. The callback runs
+     * in interrupt context when the transfer completes; readResult() then decodes the values.
+     *
+     * @param done SPI event callback.
+     *
+     * @returns None
+     */
+    void startRead(const event_callback_t& done) {
         // prepare the write buffer to trigger a sequential read
         write_buf[0]= OUT_X_L | 0x80 | 0x40;
 
+        // Timestamp from the free running us ticker, independent of how late the loop woke up
+        timestamp_us = us_ticker_read();
+
         // start sequential sample reading
-        spi.transfer(write_buf, 7, read_buf, 7, GYRO_SPI_CB, SPI_EVENT_COMPLETE);
-        GYRO_FLAGS.wait_all(SPI_FLAG);
+        spi.transfer(write_buf, 7, read_buf, 7, done, SPI_EVENT_COMPLETE);
+    }
 
+    /**
+     * Decodes the values of the last completed read.
+     *
+     * @returns An array of floats containing the X, Y, and Z values.
+     */
+    std::array<float, 3> readResult() {
         //read_buf after transfer: garbage byte, x_low, x_high, y_low, y_high, z_low, z_high
-        //Put the high and low bytes in the correct order lowB,HighB -> HighB,LowB
-        raw_x =( ((uint16_t)read_buf[2] ) << 8 ) | ((uint16_t)read_buf[1] );
-        raw_y =( ((uint16_t)read_buf[4] ) << 8 ) | ((uint16_t)read_buf[3] );
-        raw_z =( ((uint16_t)read_buf[6] ) << 8 ) | ((uint16_t)read_buf[5] );
+        std::array<float, 3> output_xyz = decode(&read_buf[1]);
+        spi.clear_transfer_buffer();
+        return output_xyz;
+    }
+
+    /**
+     * Writes one configuration register and waits for the transfer.
+     *
+     * @returns None
+     */
+    void writeRegister(uint8_t reg, uint8_t value) {
+        write_buf[0] = reg;
+        write_buf[1] = value;
+        transfer(write_buf, 2, read_buf, 2);
+    }
+
+    /**
+     * Reads one register and waits for the transfer.
+     *
+     * @returns uint8_t register value
+     */
+    uint8_t readRegister(uint8_t reg) {
+        write_buf[0] = reg | 0x80;
+        write_buf[1] = 0;
+        transfer(write_buf, 2, read_buf, 2);
+        return read_buf[1];
+    }
+
+    /**
+     * Switches to low power FIFO acquisition: 95 Hz ODR with a 12.5 Hz cutoff, samples collected in
+     * stream mode (the oldest is overwritten when full) and INT2 raised while at least watermark
+     * samples are stored.
+     *
+     * @param watermark FIFO level that raises INT2, below GYRO_FIFO_DEPTH.
+     *
+     * @returns None
+     */
+    void enableFifo(uint8_t watermark) {
+        writeRegister(CTRL_REG5, CTRL_REG5_FIFO_CONFIG);
+        writeRegister(CTRL_REG3, CTRL_REG3_FIFO_CONFIG);
+        setFifoRate(CTRL_REG1_FIFO_CONFIG, GYRO_FIFO_ODR_HZ, watermark);
+    }
+
+    /**
+     * Changes the data rate and watermark of FIFO acquisition. The FIFO is restarted, samples not read
+     * yet are discarded, since their timing would be taken for the new rate.
+     *
+     * @param ctrl_reg1 CTRL_REG1 value with the new data rate and cutoff.
+     * @param odr_hz Nominal data rate of that setting.
+     * @param watermark FIFO level that raises INT2, below GYRO_FIFO_DEPTH.
+     *
+     * @returns None
+     */
+    void setFifoRate(uint8_t ctrl_reg1, uint32_t odr_hz, uint8_t watermark) {
+        writeRegister(CTRL_REG1, ctrl_reg1);
+        fifo_watermark = watermark & FIFO_SRC_FSS;
+        fifo_period_us = 1e6f / odr_hz;
+        restartFifo();
+    }
+
+    /**
+     * Discards the FIFO contents and starts collecting again (bypass mode empties the FIFO).
+     *
+     * @returns None
+     */
+    void restartFifo() {
+        writeRegister(FIFO_CTRL_REG, FIFO_MODE_BYPASS | fifo_watermark);
+        writeRegister(FIFO_CTRL_REG, FIFO_MODE_STREAM | fifo_watermark);
+        fifo_started = false;
+    }
 
-        // Convert to degrees per sec
-        output_xyz[0] = ((float)raw_x)*(SCALING_FACTOR);
-        output_xyz[1] = ((float)raw_y)*(SCALING_FACTOR);
-        output_xyz[2] = ((float)raw_z)*(SCALING_FACTOR);
+    /**
+     * Reads every stored FIFO sample in one burst (the register address wraps from Z high back to X low
+     * in FIFO mode) and updates the measured sample period.
+     *
+     * @param xyz Destination of up to GYRO_FIFO_DEPTH samples, oldest first.
+     *
+     * @returns uint32_t number of samples read
+     */
+    uint32_t readFifo(std::array<float, 3> *xyz) {
+        // The newest stored sample is at most one period older than this
+        timestamp_us = us_ticker_read();
+        uint8_t src = readRegister(FIFO_SRC_REG);
+        uint32_t n = src & FIFO_SRC_FSS;
+        if (src & FIFO_SRC_EMPTY)
+            n = 0;
+        else if ((src & FIFO_SRC_OVRN) || n == 0)
+            n = GYRO_FIFO_DEPTH;
+        if (src & FIFO_SRC_OVRN)
+            fifo_overruns++;
+        if (n == 0)
+            return 0;
 
+        write_buf[0] = OUT_X_L | 0x80 | 0x40;
+        transfer(write_buf, 1, fifo_buf, 1 + 6 * n);
+        for (uint32_t k = 0; k < n; k++) {
+            xyz[k] = decode(&fifo_buf[1 + 6 * k]);
+        }
         spi.clear_transfer_buffer();
-        return output_xyz;
+
+        // Everything stored since the last read arrived in between, unless samples were lost
+        if (fifo_started && !(src & FIFO_SRC_OVRN))
+            fifo_period_us += ((float)(timestamp_us - last_fifo_us) / n - fifo_period_us) / 16.0f;
+        last_fifo_us = timestamp_us;
+        fifo_started = true;
+        fifo_reads++;
+        fifo_samples += n;
+        return n;
+    }
+
+    /**
+     * Estimated time of sample k of the last readFifo() that returned n samples.
+     *
+     * @returns uint32_t microsecond ticker value
+     */
+    uint32_t fifoSampleTime(uint32_t k, uint32_t n) const {
+        return timestamp_us - static_cast<uint32_t>((n - 1 - k) * fifo_period_us);
     }
     
     // Terminate spi connection early. (Avoid traffic)
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Odd length type III Hilbert transformer, group delay (HILBERT_TAPS - 1) / 2 samples
+#define HILBERT_TAPS 31
+#define HILBERT_DELAY ((HILBERT_TAPS - 1) / 2)
+// Samples aggregated into one set of statistics (~1 s at 33.3 hz)
+#define HILBERT_HOP 32
+// Instantaneous amplitude (rad/s) above which a sample counts towards a tremor burst
+#define HILBERT_BURST_AMPLITUDE 0.2f
+#define HILBERT_BURST_LOW_HZ 3.0f
+#define HILBERT_BURST_HIGH_HZ 6.0f
+
+/**
+ * @brief Per-hop summary of instantaneous amplitude and frequency
+ *
+ */
+struct HilbertStats {
+    float32_t mean_amplitude = 0.0f;
+    float32_t max_amplitude = 0.0f;
+    float32_t mean_frequency = 0.0f; // amplitude weighted, hz
+    float32_t burst_fraction = 0.0f; // fraction of samples inside a 3-6 hz burst
+};
+
+/**
+ * @brief Streaming analytic signal of a band-passed input: an FIR Hilbert transformer (arm_fir_f32)
+ *  gives the quadrature part, a matching delay line the in-phase part. Outputs instantaneous
+ *  amplitude and frequency every sample and aggregates them per hop.
+ *
+ */
+class HilbertEnvelope {
+private:
+    arm_fir_instance_f32 fir;
+    float32_t coefs[HILBERT_TAPS];
+    float32_t fir_state[HILBERT_TAPS];
+
+    float32_t delay[HILBERT_DELAY + 1] = {0};
+    uint32_t delay_index = 0;
+
+    float32_t prev_i = 0.0f;
+    float32_t prev_q = 0.0f;
+    float32_t hz_per_radian;
+
+    // Running sums for the current hop
+    float32_t sum_amplitude = 0.0f;
+    float32_t sum_weighted_freq = 0.0f;
+    float32_t max_amplitude = 0.0f;
+    uint32_t burst_samples = 0;
+    uint32_t hop_samples = 0;
+
+public:
+    // Latest per-sample outputs
+    float32_t amplitude = 0.0f;
+    float32_t frequency = 0.0f;
+    // Statistics of the last completed hop
+    HilbertStats stats;
+
+    /** CONSTRUCTOR
+     * Designs a Hamming windowed Hilbert transformer.
+     *
+     * @param sample_rate_hz Sampling rate of the input in hz.
+     *
+     * @returns None
+     */
+    HilbertEnvelope(float32_t sample_rate_hz) : hz_per_radian(sample_rate_hz / (2.0f * PI)) {
+        float32_t h[HILBERT_TAPS];
+        for (int32_t n = 0; n < HILBERT_TAPS; n++) {
+            int32_t k = n - HILBERT_DELAY;
+            float32_t window = 0.54f - 0.46f * cosf(2.0f * PI * n / (HILBERT_TAPS - 1));
+            h[n] = (k % 2 == 0) ? 0.0f : window * 2.0f / (PI * k);
+        }
+        // arm_fir_f32 expects the coefficients in time reversed order
+        for (int32_t n = 0; n < HILBERT_TAPS; n++) {
+            coefs[n] = h[HILBERT_TAPS - 1 - n];
+        }
+        arm_fir_init_f32(&fir, HILBERT_TAPS, coefs, fir_state, 1);
+    }
+
+    /**
+     * Processes one band-passed sample.
+     *
+     * @param sample Band-passed input sample.
+     *
+     * @returns True when a hop completed and stats were updated, False otherwise.
+     */
+    bool update(float32_t sample) {
+        // Quadrature part from the FIR, in-phase part delayed by the FIR group delay
+        float32_t q;
+        arm_fir_f32(&fir, &sample, &q, 1);
+        delay[delay_index] = sample;
+        delay_index = delay_index == HILBERT_DELAY ? 0 : delay_index + 1;
+        float32_t i = delay[delay_index];
+
+        arm_sqrt_f32(i * i + q * q, &amplitude);
+
+        // Phase advance from the conjugate product of consecutive analytic samples
+        float32_t phase_step;
+        arm_atan2_f32(prev_i * q - prev_q * i, prev_i * i + prev_q * q, &phase_step);
+        frequency = phase_step * hz_per_radian;
+        prev_i = i;
+        prev_q = q;
+
+        sum_amplitude += amplitude;
+        sum_weighted_freq += amplitude * frequency;
+        if (amplitude > max_amplitude)
+            max_amplitude = amplitude;
+        if (amplitude >= HILBERT_BURST_AMPLITUDE && frequency >= HILBERT_BURST_LOW_HZ && frequency <= HILBERT_BURST_HIGH_HZ)
+            burst_samples++;
+
+        if (++hop_samples < HILBERT_HOP)
+            return false;
+
+        stats.mean_amplitude = sum_amplitude / HILBERT_HOP;
+        stats.max_amplitude = max_amplitude;
+        stats.mean_frequency = sum_amplitude > 0.0f ? sum_weighted_freq / sum_amplitude : 0.0f;
+        stats.burst_fraction = static_cast<float32_t>(burst_samples) / HILBERT_HOP;
+
+        sum_amplitude = 0.0f;
+        sum_weighted_freq = 0.0f;
+        max_amplitude = 0.0f;
+        burst_samples = 0;
+        hop_samples = 0;
+        return true;
+    }
+};
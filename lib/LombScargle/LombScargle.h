@@ -0,0 +1,164 @@
+#pragma once
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+// Oversampling of the frequency grid relative to 1 / window length
+#define LOMB_OVERSAMPLE 2.0f
+// Highest evaluated frequency relative to the mean Nyquist frequency (8 hz of 16.7 hz)
+#define LOMB_HIFAC 0.5f
+// Samples per call the grid is sized for
+#define LOMB_MAX_SAMPLES 256
+// Points used to extirpolate each sample onto the FFT grid
+#define LOMB_MACC 4
+// Complex FFT used for the extirpolated sums, sized as Press & Rybicki do: the power of two at or above
+// LOMB_OVERSAMPLE * LOMB_HIFAC * LOMB_MAX_SAMPLES * LOMB_MACC. Against a direct evaluation the power stays
+// within 1% up to 8 hz, a 512-point grid lost up to 11% at 7-8 hz (test/test_lomb_scargle)
+#define LOMB_FFT_SIZE 1024
+// Largest number of frequencies kept for the band
+#define LOMB_MAX_BINS 160
+
+/**
+ * @brief Fast Lomb-Scargle periodogram (Press & Rybicki extirpolation) for unevenly timed samples.
+ *
+ * Each sample and its doubled phase are spread onto a regular grid with Lagrange extirpolation,
+ * both grids go through one packed arm_cfft_f32, and the normalized periodogram is evaluated
+ * only over the requested band. Missing or jittered samples need no resampling: pass the
+ * timestamps that were actually captured.
+ */
+class LombScargle {
+private:
+    static_assert(LOMB_FFT_SIZE >= LOMB_OVERSAMPLE * LOMB_HIFAC * LOMB_MAX_SAMPLES * LOMB_MACC, "Lomb-Scargle grid too small");
+    const arm_cfft_instance_f32 *fft = &arm_cfft_sR_f32_len1024;
+    float32_t grid[LOMB_FFT_SIZE * 2];
+
+    /**
+     * Extirpolates value onto grid[] (interleaved complex, into the real or imaginary lane) around
+     * the fractional, zero based position x, wrapping around the end of the grid.
+     *
+     * @returns None
+     */
+    void spread(float32_t value, float32_t x, uint32_t lane) {
+        static const float32_t factorial[LOMB_MACC + 1] = {1.0f, 1.0f, 2.0f, 6.0f, 24.0f};
+        int32_t ix = static_cast<int32_t>(x);
+        if (x == static_cast<float32_t>(ix)) {
+            grid[2 * (ix % LOMB_FFT_SIZE) + lane] += value;
+            return;
+        }
+
+        int32_t lo = static_cast<int32_t>(floorf(x - 0.5f * LOMB_MACC + 1.0f));
+        int32_t hi = lo + LOMB_MACC - 1;
+        float32_t fac = x - lo;
+        for (int32_t j = lo + 1; j <= hi; j++) {
+            fac *= x - j;
+        }
+        float32_t den = factorial[LOMB_MACC - 1];
+        grid[2 * ((hi + LOMB_FFT_SIZE) % LOMB_FFT_SIZE) + lane] += value * fac / (den * (x - hi));
+        for (int32_t j = hi - 1; j >= lo; j--) {
+            den = (den / (j + 1 - lo)) * (j - hi);
+            grid[2 * ((j + LOMB_FFT_SIZE) % LOMB_FFT_SIZE) + lane] += value * fac / (den * (x - j));
+        }
+    }
+
+public:
+    // Normalized power over the last evaluated band, power[i] is at first_hz + i * step_hz
+    float32_t power[LOMB_MAX_BINS];
+    uint32_t num_bins = 0;
+    float32_t first_hz = 0.0f;
+    float32_t step_hz = 0.0f;
+    // Peak of the last evaluated band
+    float32_t peak_hz = 0.0f;
+    float32_t peak_power = 0.0f;
+
+    /**
+     * Computes the periodogram over [low_hz, high_hz].
+     *
+     * @param times Sample times in seconds, increasing.
+     * @param values Sample values, read with the given stride.
+     * @param n Number of samples actually captured, up to LOMB_MAX_SAMPLES.
+     * @param low_hz Lowest frequency of interest.
+     * @param high_hz Highest frequency of interest, up to LOMB_HIFAC times the mean Nyquist frequency.
+     * @param stride Distance between consecutive values (2 for an interleaved complex buffer).
+     *
+     * @returns float frequency of the band peak in hz
+     */
+    float32_t compute(const float32_t *times, const float32_t *values, uint32_t n, float32_t low_hz, float32_t high_hz, uint32_t stride = 1) {
+        peak_hz = 0.0f;
+        peak_power = 0.0f;
+        num_bins = 0;
+        if (n < 4 || times[n - 1] <= times[0])
+            return 0.0f;
+
+        float32_t mean = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            mean += values[i * stride];
+        }
+        mean /= n;
+        float32_t variance = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            float32_t d = values[i * stride] - mean;
+            variance += d * d;
+        }
+        variance /= (n - 1);
+        if (variance <= 0.0f)
+            return 0.0f;
+
+        // Grid spacing chosen so bin j of the transform is frequency j * step_hz
+        float32_t span = times[n - 1] - times[0];
+        step_hz = 1.0f / (span * LOMB_OVERSAMPLE);
+        float32_t fac = LOMB_FFT_SIZE * step_hz;
+
+        // Data goes on the real lane, the unit weights at doubled phase on the imaginary lane
+        memset(grid, 0, sizeof(grid));
+        for (uint32_t i = 0; i < n; i++) {
+            float32_t ck = fmodf((times[i] - times[0]) * fac, static_cast<float32_t>(LOMB_FFT_SIZE));
+            float32_t ckk = fmodf(2.0f * ck, static_cast<float32_t>(LOMB_FFT_SIZE));
+            spread(values[i * stride] - mean, ck, 0);
+            spread(1.0f, ckk, 1);
+        }
+        arm_cfft_f32(fft, grid, 0, 1);
+
+        uint32_t first = static_cast<uint32_t>(ceilf(low_hz / step_hz));
+        uint32_t last = static_cast<uint32_t>(floorf(high_hz / step_hz));
+        if (first < 1)
+            first = 1;
+        if (last >= LOMB_FFT_SIZE / 2)
+            last = LOMB_FFT_SIZE / 2 - 1;
+        if (last - first + 1 > LOMB_MAX_BINS)
+            last = first + LOMB_MAX_BINS - 1;
+        first_hz = first * step_hz;
+
+        for (uint32_t j = first; j <= last; j++) {
+            // Unpack the two real sequences; CMSIS uses e^-i, the sums need e^+i so imaginary parts flip
+            float32_t zr = grid[2 * j], zi = grid[2 * j + 1];
+            float32_t mr = grid[2 * (LOMB_FFT_SIZE - j)], mi = grid[2 * (LOMB_FFT_SIZE - j) + 1];
+            float32_t c1 = 0.5f * (zr + mr);
+            float32_t s1 = -0.5f * (zi - mi);
+            float32_t c2 = 0.5f * (zi + mi);
+            float32_t s2 = 0.5f * (zr - mr);
+
+            float32_t hypo;
+            arm_sqrt_f32(c2 * c2 + s2 * s2, &hypo);
+            if (hypo <= 0.0f)
+                hypo = 1e-12f;
+            float32_t hc2wt = 0.5f * c2 / hypo;
+            float32_t hs2wt = 0.5f * s2 / hypo;
+            float32_t cwt, swt;
+            arm_sqrt_f32(0.5f + hc2wt, &cwt);
+            arm_sqrt_f32(0.5f - hc2wt, &swt);
+            if (hs2wt < 0.0f)
+                swt = -swt;
+            float32_t den = 0.5f * n + hc2wt * c2 + hs2wt * s2;
+            float32_t cterm = (cwt * c1 + swt * s1);
+            float32_t sterm = (cwt * s1 - swt * c1);
+            float32_t p = (cterm * cterm / den + sterm * sterm / (n - den)) / (2.0f * variance);
+
+            power[num_bins++] = p;
+            if (p > peak_power) {
+                peak_power = p;
+                peak_hz = j * step_hz;
+            }
+        }
+        return peak_hz;
+    }
+};
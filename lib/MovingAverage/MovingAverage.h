@@ -33,7 +33,7 @@ public:
         window[index] = new_value;
 
         // Set index to next data slot, wrapping around to oldest
-        if (index < WINDOW_SIZE)
+        if (index < WINDOW_SIZE - 1)
             index++;
         else
             index = 0;
@@ -62,6 +62,8 @@ public:
             window[i] = 0;
         }
         size = 0;
+        index = 0;
+        sum = 0;
     }
 };
 
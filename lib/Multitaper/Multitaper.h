@@ -0,0 +1,191 @@
+#pragma once
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+// Window length and number of DPSS tapers (NW = 2.5), keep in sync with tools/gen_dpss.py.
+// The taper count must be even: two real tapered copies share one complex transform
+#define MULTITAPER_SIZE 256
+#define MULTITAPER_TAPERS 4
+#define MULTITAPER_BINS (MULTITAPER_SIZE / 2 + 1)
+// Iterations of Thomson's adaptive weighting
+#define MULTITAPER_ADAPT_ITERATIONS 3
+// Welch reference: Hann windowed segments with 50% overlap
+#define WELCH_SEGMENT 64
+#define WELCH_HOP 32
+#define WELCH_BINS (WELCH_SEGMENT / 2 + 1)
+
+// Flash resident tapers generated by tools/gen_dpss.py (src/dpss_tapers.c)
+extern "C" {
+    extern const float32_t dpss_tapers[];
+    extern const float32_t dpss_eigenvalues[];
+}
+
+/**
+ * @brief Multitaper power spectral density of a single window with adaptive weighting, plus the
+ *  plain periodogram and a Welch estimate for comparison.
+ *
+ * Each pair of tapered copies of the window is packed into the real and imaginary lanes of one
+ * arm_cfft_f32 and separated afterwards, so K tapers cost K/2 transforms sharing one twiddle table
+ * and one work buffer. All outputs are one-sided PSDs in input units^2 per bin with unit energy
+ * windows, so the three estimators are directly comparable.
+ */
+class Multitaper {
+private:
+    const arm_cfft_instance_f32 *fft = &arm_cfft_sR_f32_len256;
+    const arm_cfft_instance_f32 *welch_fft = &arm_cfft_sR_f32_len64;
+    float32_t work[MULTITAPER_SIZE * 2];
+    float32_t eigen[MULTITAPER_TAPERS][MULTITAPER_BINS];
+    float32_t hann[WELCH_SEGMENT];
+
+    /**
+     * Mean and variance of a strided sequence.
+     *
+     * @returns float variance, mean through the pointer
+     */
+    static float32_t moments(const float32_t *x, uint32_t n, uint32_t stride, float32_t *mean) {
+        float32_t sum = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            sum += x[i * stride];
+        }
+        *mean = sum / n;
+        float32_t var = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            float32_t d = x[i * stride] - *mean;
+            var += d * d;
+        }
+        return var / n;
+    }
+
+public:
+    // Last multitaper estimate
+    float32_t psd[MULTITAPER_BINS];
+
+    /** CONSTRUCTOR
+     * Builds the unit energy Hann window of the Welch reference.
+     *
+     * @returns None
+     */
+    Multitaper() {
+        float32_t energy = 0.0f;
+        for (uint32_t i = 0; i < WELCH_SEGMENT; i++) {
+            hann[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / WELCH_SEGMENT);
+            energy += hann[i] * hann[i];
+        }
+        float32_t scale;
+        arm_sqrt_f32(1.0f / energy, &scale);
+        arm_scale_f32(hann, scale, hann, WELCH_SEGMENT);
+    }
+
+    /**
+     * Computes the adaptively weighted multitaper PSD of MULTITAPER_SIZE samples into psd[].
+     *
+     * @param x Input samples, read with the given stride.
+     * @param stride Distance between consecutive samples (2 for an interleaved complex buffer).
+     *
+     * @returns None
+     */
+    void compute(const float32_t *x, uint32_t stride = 1) {
+        float32_t mean;
+        float32_t variance = moments(x, MULTITAPER_SIZE, stride, &mean);
+
+        // Eigenspectra, two tapers per transform: z = a + jb  ->  A[k] = (Z[k] + Z*[N-k]) / 2, B[k] = (Z[k] - Z*[N-k]) / 2j
+        for (uint32_t t = 0; t < MULTITAPER_TAPERS; t += 2) {
+            const float32_t *taper_a = &dpss_tapers[t * MULTITAPER_SIZE];
+            const float32_t *taper_b = &dpss_tapers[(t + 1) * MULTITAPER_SIZE];
+            for (uint32_t i = 0; i < MULTITAPER_SIZE; i++) {
+                work[2 * i] = x[i * stride] * taper_a[i];
+                work[2 * i + 1] = x[i * stride] * taper_b[i];
+            }
+            arm_cfft_f32(fft, work, 0, 1);
+            for (uint32_t k = 0; k < MULTITAPER_BINS; k++) {
+                uint32_t m = (MULTITAPER_SIZE - k) % MULTITAPER_SIZE;
+                float32_t zr = work[2 * k], zi = work[2 * k + 1];
+                float32_t mr = work[2 * m], mi = work[2 * m + 1];
+                float32_t ar = 0.5f * (zr + mr), ai = 0.5f * (zi - mi);
+                float32_t br = 0.5f * (zi + mi), bi = -0.5f * (zr - mr);
+                eigen[t][k] = ar * ar + ai * ai;
+                eigen[t + 1][k] = br * br + bi * bi;
+            }
+        }
+
+        // Thomson's adaptive weights, started from the two best concentrated tapers
+        for (uint32_t k = 0; k < MULTITAPER_BINS; k++) {
+            float32_t s = 0.5f * (eigen[0][k] + eigen[1][k]);
+            for (uint32_t it = 0; it < MULTITAPER_ADAPT_ITERATIONS; it++) {
+                float32_t num = 0.0f;
+                float32_t den = 0.0f;
+                for (uint32_t t = 0; t < MULTITAPER_TAPERS; t++) {
+                    float32_t lambda = dpss_eigenvalues[t];
+                    float32_t d = s / (lambda * s + (1.0f - lambda) * variance + 1e-20f);
+                    float32_t w = lambda * d * d; // d_k^2 with d_k = sqrt(lambda) s / (...)
+                    num += w * eigen[t][k];
+                    den += w;
+                }
+                s = den > 0.0f ? num / den : 0.0f;
+            }
+            psd[k] = s;
+        }
+    }
+
+    /**
+     * Single periodogram (rectangular window) of MULTITAPER_SIZE samples, the estimate the FFT path
+     * has always used, on the same scale as compute().
+     *
+     * @param x Input samples, read with the given stride.
+     * @param stride Distance between consecutive samples.
+     * @param out MULTITAPER_BINS power values.
+     *
+     * @returns None
+     */
+    void periodogram(const float32_t *x, uint32_t stride, float32_t *out) {
+        for (uint32_t i = 0; i < MULTITAPER_SIZE; i++) {
+            work[2 * i] = x[i * stride];
+            work[2 * i + 1] = 0.0f;
+        }
+        arm_cfft_f32(fft, work, 0, 1);
+        arm_cmplx_mag_squared_f32(work, out, MULTITAPER_BINS);
+        arm_scale_f32(out, 1.0f / MULTITAPER_SIZE, out, MULTITAPER_BINS);
+    }
+
+    /**
+     * Welch estimate over MULTITAPER_SIZE samples (Hann, WELCH_SEGMENT points, WELCH_HOP hop).
+     *
+     * @param x Input samples, read with the given stride.
+     * @param stride Distance between consecutive samples.
+     * @param out WELCH_BINS power values.
+     *
+     * @returns None
+     */
+    void welch(const float32_t *x, uint32_t stride, float32_t *out) {
+        float32_t segment_power[WELCH_BINS];
+        uint32_t segments = 0;
+        memset(out, 0, WELCH_BINS * sizeof(float32_t));
+        for (uint32_t start = 0; start + WELCH_SEGMENT <= MULTITAPER_SIZE; start += WELCH_HOP) {
+            for (uint32_t i = 0; i < WELCH_SEGMENT; i++) {
+                work[2 * i] = x[(start + i) * stride] * hann[i];
+                work[2 * i + 1] = 0.0f;
+            }
+            arm_cfft_f32(welch_fft, work, 0, 1);
+            arm_cmplx_mag_squared_f32(work, segment_power, WELCH_BINS);
+            arm_add_f32(out, segment_power, out, WELCH_BINS);
+            segments++;
+        }
+        arm_scale_f32(out, 1.0f / segments, out, WELCH_BINS);
+    }
+
+    /**
+     * Bin to bin variability (standard deviation / mean) of a PSD over [first, last]. On a flat
+     * background this is the estimator's relative standard error: ~1 for a periodogram, ~1/sqrt(K)
+     * for K independent averages.
+     *
+     * @returns float coefficient of variation
+     */
+    static float32_t variability(const float32_t *power, uint32_t first, uint32_t last) {
+        uint32_t n = last - first + 1;
+        float32_t mean, std;
+        arm_mean_f32(power + first, n, &mean);
+        arm_std_f32(power + first, n, &std);
+        return mean > 0.0f ? std / mean : 0.0f;
+    }
+};
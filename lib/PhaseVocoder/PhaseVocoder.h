@@ -0,0 +1,152 @@
+#pragma once
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+// Short frame transformed with arm_cfft_f32 (~1.9 s at 33.3 hz) and the hop between frames
+#define VOCODER_FRAME 64
+#define VOCODER_HOP 16
+// Band searched for the peak bin
+#define VOCODER_LOW_HZ 2.0f
+#define VOCODER_HIGH_HZ 8.0f
+
+/**
+ * @brief Phase vocoder frequency tracker on short overlapping frames.
+ *
+ * A 64-point Hann windowed FFT runs every VOCODER_HOP samples. The bin spacing is coarse (~0.52 hz),
+ * but the phase advance of the peak bin between two frames one hop apart is
+ *   dphi = 2 pi f hop / fs
+ * so the deviation from the bin centre's expected advance gives the frequency to a small fraction
+ * of a bin. Only the complex values of the previous frame's band bins are kept; the refinement
+ * itself is one conjugate product and one atan2 per frame.
+ */
+class PhaseVocoder {
+private:
+    const arm_cfft_instance_f32 *fft = &arm_cfft_sR_f32_len64;
+    float32_t history[VOCODER_FRAME] = {0};
+    uint32_t head = 0;
+    uint32_t filled = 0;
+    uint32_t hop_count = 0;
+
+    float32_t window[VOCODER_FRAME];
+    float32_t frame[VOCODER_FRAME * 2];
+    float32_t magnitude[VOCODER_FRAME / 2];
+    float32_t previous[VOCODER_FRAME]; // complex values of bins 0..FRAME/2-1 of the last frame
+    bool has_previous = false;
+
+    uint32_t first_bin;
+    uint32_t last_bin;
+    float32_t bin_hz;
+
+    // Magnitude weighted accumulation over the current window
+    float32_t sum_weighted_freq = 0.0f;
+    float32_t sum_weight = 0.0f;
+
+    void processFrame() {
+        // Oldest sample first, windowed, as interleaved complex
+        for (uint32_t i = 0; i < VOCODER_FRAME; i++) {
+            frame[2 * i] = history[(head + i) % VOCODER_FRAME] * window[i];
+            frame[2 * i + 1] = 0.0f;
+        }
+        arm_cfft_f32(fft, frame, 0, 1);
+        arm_cmplx_mag_f32(frame, magnitude, VOCODER_FRAME / 2);
+
+        uint32_t peak = first_bin;
+        for (uint32_t k = first_bin + 1; k <= last_bin; k++) {
+            if (magnitude[k] > magnitude[peak])
+                peak = k;
+        }
+
+        if (has_previous) {
+            // Phase advance of the peak bin: angle(X_k conj(X_k,prev))
+            float32_t re = frame[2 * peak] * previous[2 * peak] + frame[2 * peak + 1] * previous[2 * peak + 1];
+            float32_t im = frame[2 * peak + 1] * previous[2 * peak] - frame[2 * peak] * previous[2 * peak + 1];
+            float32_t advance;
+            arm_atan2_f32(im, re, &advance);
+
+            // Deviation from the bin centre's advance, wrapped to [-pi, pi)
+            float32_t deviation = advance - 2.0f * PI * peak * VOCODER_HOP / VOCODER_FRAME;
+            deviation -= 2.0f * PI * floorf(deviation / (2.0f * PI) + 0.5f);
+            float32_t bins = peak + deviation * VOCODER_FRAME / (2.0f * PI * VOCODER_HOP);
+
+            frequency = bins * bin_hz;
+            peak_magnitude = magnitude[peak];
+            sum_weighted_freq += peak_magnitude * frequency;
+            sum_weight += peak_magnitude;
+        }
+        memcpy(previous, frame, sizeof(previous));
+        has_previous = true;
+    }
+
+public:
+    // Refined frequency of the last frame and its peak magnitude
+    float32_t frequency = 0.0f;
+    float32_t peak_magnitude = 0.0f;
+    // Magnitude weighted frequency of the last completed window
+    float32_t window_frequency = 0.0f;
+
+    /** CONSTRUCTOR
+     * Builds the Hann window and the searched bin range.
+     *
+     * @param sample_rate_hz Sampling rate of the input in hz.
+     *
+     * @returns None
+     */
+    PhaseVocoder(float32_t sample_rate_hz) : bin_hz(sample_rate_hz / VOCODER_FRAME) {
+        for (uint32_t i = 0; i < VOCODER_FRAME; i++) {
+            window[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / VOCODER_FRAME);
+        }
+        first_bin = static_cast<uint32_t>(ceilf(VOCODER_LOW_HZ / bin_hz));
+        last_bin = static_cast<uint32_t>(floorf(VOCODER_HIGH_HZ / bin_hz));
+        if (first_bin < 1)
+            first_bin = 1;
+        if (last_bin > VOCODER_FRAME / 2 - 1)
+            last_bin = VOCODER_FRAME / 2 - 1;
+    }
+
+    /**
+     * Appends one sample, transforming a frame every VOCODER_HOP samples once the history is full.
+     *
+     * @param sample Input sample (band-passed works best).
+     *
+     * @returns True if a frame was processed, False otherwise.
+     */
+    bool update(float32_t sample) {
+        history[head] = sample;
+        head = (head + 1) % VOCODER_FRAME;
+        if (filled < VOCODER_FRAME)
+            filled++;
+        if (++hop_count < VOCODER_HOP || filled < VOCODER_FRAME)
+            return false;
+        hop_count = 0;
+        processFrame();
+        return true;
+    }
+
+    /**
+     * Forgets the frame history and the previous frame, for a stream that resumes after a gap. The next
+     * frame is processed once VOCODER_FRAME new samples arrived, and only the one after it is refined.
+     *
+     * @returns None
+     */
+    void reset() {
+        head = 0;
+        filled = 0;
+        hop_count = 0;
+        has_previous = false;
+    }
+
+    /**
+     * Latches the window frequency and starts a new window. Frame history carries over, call reset()
+     * first if the next window does not continue this one.
+     *
+     * @returns float window frequency in hz
+     */
+    float32_t endWindow() {
+        if (sum_weight > 0.0f)
+            window_frequency = sum_weighted_freq / sum_weight;
+        sum_weighted_freq = 0.0f;
+        sum_weight = 0.0f;
+        return window_frequency;
+    }
+};
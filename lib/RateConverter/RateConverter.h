@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+
+/**
+ * @brief Moves a stream of timestamped 3-axis samples from a faster sensor rate onto a fixed output
+ *  grid, interpolating linearly between the two input samples around each grid point.
+ *
+ * Meant for the gyroscope FIFO (95 or 190 Hz in, SAMPLING_FREQ out): the sensor's 12.5 Hz low-pass keeps
+ * the input band-limited far below its rate, so linear interpolation is accurate over the tremor band
+ * (worst error over 3-8 Hz 3.4% of the amplitude at 95 Hz, 0.8% at 190 Hz). The input must be faster than the grid; grid points that fall into a gap of the
+ * input longer than one grid period (a FIFO overrun) are skipped and counted rather than interpolated
+ * across the gap, and the timestamps of the output show it.
+ */
+class RateConverter {
+private:
+    uint32_t period_us;
+    std::array<float, 3> previous;
+    uint32_t previous_us = 0;
+    uint32_t next_us = 0;
+    bool primed = false;
+
+    static int32_t diff(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b);
+    }
+
+public:
+    // Last grid sample and its time
+    std::array<float, 3> output;
+    uint32_t output_us = 0;
+    uint32_t skipped = 0;
+
+    /** CONSTRUCTOR
+     *
+     * @param _period_us Period of the output grid.
+     *
+     * @returns None
+     */
+    RateConverter(uint32_t _period_us) : period_us(_period_us) {}
+
+    /**
+     * Starts a new grid on the next input sample.
+     *
+     * @returns None
+     */
+    void reset() {
+        primed = false;
+    }
+
+    /**
+     * Adds one input sample.
+     *
+     * @param xyz Input sample.
+     * @param t_us Microsecond ticker time of the input sample.
+     *
+     * @returns True if a grid point was passed and output holds its sample, False otherwise.
+     */
+    bool update(const std::array<float, 3>& xyz, uint32_t t_us) {
+        if (!primed) {
+            primed = true;
+            previous = output = xyz;
+            previous_us = output_us = t_us;
+            next_us = t_us + period_us;
+            return true;
+        }
+        // Estimated times can step back slightly between two FIFO reads
+        if (diff(t_us, previous_us) <= 0)
+            return false;
+
+        bool ready = false;
+        if (diff(t_us, previous_us) > static_cast<int32_t>(period_us)) {
+            // Gap, continue the grid after this sample
+            while (diff(next_us, t_us) <= 0) {
+                next_us += period_us;
+                skipped++;
+            }
+        } else if (diff(next_us, t_us) <= 0) {
+            float frac = static_cast<float>(diff(next_us, previous_us)) / diff(t_us, previous_us);
+            for (int axis = 0; axis < 3; axis++) {
+                output[axis] = previous[axis] + frac * (xyz[axis] - previous[axis]);
+            }
+            output_us = next_us;
+            next_us += period_us;
+            ready = true;
+        }
+        previous = xyz;
+        previous_us = t_us;
+        return ready;
+    }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Largest number of input samples per window
+#define RESAMPLE_MAX_POINTS 256
+// An interval longer than this many nominal periods counts as a dropped sample
+#define RESAMPLE_GAP_FACTOR 1.5f
+
+/**
+ * @brief Interpolation used to move samples onto the uniform grid
+ *
+ */
+enum ResampleMethod {
+    RESAMPLE_LINEAR,
+    RESAMPLE_SPLINE
+};
+
+/**
+ * @brief Timing statistics of one window of timestamped samples
+ *
+ */
+struct JitterStats {
+    float32_t mean_interval = 0.0f; // seconds
+    float32_t std_interval = 0.0f;  // seconds
+    float32_t min_interval = 0.0f;  // seconds
+    float32_t max_interval = 0.0f;  // seconds
+    float32_t rms_grid_error = 0.0f; // rms distance of the sample times from the nominal grid, seconds
+    uint32_t gaps = 0;               // intervals longer than RESAMPLE_GAP_FACTOR nominal periods
+};
+
+/**
+ * @brief Maps a jittered, timestamped sample stream onto an exact uniform grid at the nominal rate
+ *  (natural cubic spline with arm_spline_f32, or linear) and measures the timing jitter.
+ *
+ * Spectral stages downstream assume bin k is k * fs / N; if the real spacing differs, every
+ * frequency is scaled by nominal / actual rate and the jitter spreads energy into a noise floor.
+ */
+class Resampler {
+private:
+    arm_spline_instance_f32 spline;
+    float32_t coeffs[3 * (RESAMPLE_MAX_POINTS - 1)];
+    float32_t scratch[2 * RESAMPLE_MAX_POINTS - 1];
+    float32_t grid[RESAMPLE_MAX_POINTS];
+    float32_t period;
+
+public:
+    // Statistics of the last measured window
+    JitterStats stats;
+
+    /** CONSTRUCTOR
+     *
+     * @param sample_rate_hz Nominal sampling rate, the rate of the output grid.
+     *
+     * @returns None
+     */
+    Resampler(float32_t sample_rate_hz) : period(1.0f / sample_rate_hz) {}
+
+    /**
+     * Measures the sampling intervals of a window.
+     *
+     * @param times Sample times in seconds, strictly increasing.
+     * @param n Number of samples.
+     *
+     * @returns JitterStats of the window, also kept in stats
+     */
+    const JitterStats& measure(const float32_t *times, uint32_t n) {
+        stats = JitterStats();
+        if (n < 2)
+            return stats;
+
+        float32_t sum = 0.0f;
+        float32_t sum_squares = 0.0f;
+        stats.min_interval = times[1] - times[0];
+        stats.max_interval = stats.min_interval;
+        for (uint32_t i = 1; i < n; i++) {
+            float32_t dt = times[i] - times[i - 1];
+            sum += dt;
+            sum_squares += dt * dt;
+            if (dt < stats.min_interval)
+                stats.min_interval = dt;
+            if (dt > stats.max_interval)
+                stats.max_interval = dt;
+            if (dt > RESAMPLE_GAP_FACTOR * period)
+                stats.gaps++;
+        }
+        stats.mean_interval = sum / (n - 1);
+        float32_t variance = sum_squares / (n - 1) - stats.mean_interval * stats.mean_interval;
+        arm_sqrt_f32(variance > 0.0f ? variance : 0.0f, &stats.std_interval);
+
+        // Distance from the best fitting uniform grid (times[0] + i * mean_interval), i.e. the phase jitter
+        float32_t grid_error = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            float32_t e = times[i] - (times[0] + i * stats.mean_interval);
+            grid_error += e * e;
+        }
+        arm_sqrt_f32(grid_error / n, &stats.rms_grid_error);
+        return stats;
+    }
+
+    /**
+     * Relative frequency error of a spectrum that assumes the nominal rate for the last measured window.
+     *
+     * @returns float (reported - true) / true frequency
+     */
+    float32_t frequencyScaleError() {
+        return stats.mean_interval > 0.0f ? stats.mean_interval / period - 1.0f : 0.0f;
+    }
+
+    /**
+     * Resamples values[] taken at times[] onto t = times[0] + k / fs, k < n. Grid points past the
+     * last sample hold its value.
+     *
+     * @param times Sample times in seconds, strictly increasing.
+     * @param values Sample values (contiguous).
+     * @param n Number of samples, at most RESAMPLE_MAX_POINTS.
+     * @param output Destination, written with the given stride.
+     * @param stride Distance between consecutive outputs (2 for an interleaved complex buffer).
+     * @param method Spline or linear interpolation.
+     *
+     * @returns None
+     */
+    void resample(const float32_t *times, const float32_t *values, uint32_t n, float32_t *output, uint32_t stride = 1,
+                  ResampleMethod method = RESAMPLE_SPLINE) {
+        if (n < 2 || n > RESAMPLE_MAX_POINTS)
+            return;
+
+        const float32_t last = times[n - 1];
+        for (uint32_t k = 0; k < n; k++) {
+            float32_t t = times[0] + k * period;
+            grid[k] = t < last ? t : last;
+        }
+
+        if (method == RESAMPLE_SPLINE) {
+            arm_spline_init_f32(&spline, ARM_SPLINE_NATURAL, times, values, n, coeffs, scratch);
+            arm_spline_f32(&spline, grid, scratch, n);
+            for (uint32_t k = 0; k < n; k++) {
+                output[k * stride] = scratch[k];
+            }
+            return;
+        }
+
+        // arm_linear_interp_f32 needs a uniformly spaced table, so walk the segments directly
+        uint32_t i = 0;
+        for (uint32_t k = 0; k < n; k++) {
+            while (i + 2 < n && times[i + 1] <= grid[k]) {
+                i++;
+            }
+            float32_t frac = (grid[k] - times[i]) / (times[i + 1] - times[i]);
+            frac = frac > 1.0f ? 1.0f : frac;
+            output[k * stride] = values[i] + frac * (values[i + 1] - values[i]);
+        }
+    }
+};
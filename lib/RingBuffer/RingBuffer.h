@@ -0,0 +1,259 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Alignment of the producer and consumer indices, so they never share a cache line (Cortex-M4 has no
+// data cache, the padding only matters on a host or a cached core)
+#ifndef RING_BUFFER_ALIGN
+#if defined(__arm__)
+#define RING_BUFFER_ALIGN 32
+#else
+#define RING_BUFFER_ALIGN 64
+#endif
+#endif
+
+// Interrupt handlers and the consumer rely on plain loads and stores of the indices
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "RingBuffer needs lock-free 32-bit atomics");
+
+/* What push() does when the ring is full */
+enum RingOverrun {
+    RING_DROP_NEWEST,   // reject the new element, the queued ones stay intact
+    RING_OVERWRITE_OLDEST // always accept, the consumer skips whatever was overwritten
+};
+
+/**
+ * @brief Wait-free single-producer / single-consumer ring buffer with power-of-two capacity.
+ *
+ * The producer only writes head, the consumer only writes tail; both are free-running 32-bit counters
+ * (the capacity divides 2^32, so wrap-around needs no special case) published with release stores and
+ * read with acquire loads. One side may be an interrupt handler and the other thread code, or both
+ * std::threads on a host. Bulk push()/pop() copy at most two contiguous runs; writeSpan()/readSpan()
+ * hand out the contiguous run itself for zero-copy access (RING_DROP_NEWEST only).
+ *
+ * With RING_OVERWRITE_OLDEST the producer never waits or fails. The consumer copies an element and then
+ * re-reads head; if the producer lapped it meanwhile the copy is discarded and counted as overwritten,
+ * so the consumer is lock-free rather than wait-free in this mode.
+ *
+ * @tparam T Trivially copyable element type.
+ * @tparam CAPACITY Number of elements, a power of two.
+ * @tparam POLICY Overrun policy.
+ */
+template <class T, uint32_t CAPACITY, RingOverrun POLICY = RING_DROP_NEWEST>
+class RingBuffer {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "RingBuffer capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "RingBuffer elements are copied with memcpy");
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    alignas(RING_BUFFER_ALIGN) std::atomic<uint32_t> head{0};     // next slot to write, producer owned
+    std::atomic<uint32_t> rejected{0};                             // producer owned
+    alignas(RING_BUFFER_ALIGN) std::atomic<uint32_t> tail{0};     // next slot to read, consumer owned
+    std::atomic<uint32_t> overwritten{0};                          // consumer owned
+    alignas(RING_BUFFER_ALIGN) T slots[CAPACITY];
+
+    /**
+     * Copies n elements into the ring starting at index, in at most two runs.
+     *
+     * @returns None
+     */
+    void copyIn(uint32_t index, const T *src, uint32_t n) {
+        uint32_t first = CAPACITY - (index & MASK);
+        if (first > n)
+            first = n;
+        memcpy(&slots[index & MASK], src, first * sizeof(T));
+        memcpy(&slots[0], src + first, (n - first) * sizeof(T));
+    }
+
+    /**
+     * Copies n elements out of the ring starting at index, in at most two runs.
+     *
+     * @returns None
+     */
+    void copyOut(uint32_t index, T *dst, uint32_t n) const {
+        uint32_t first = CAPACITY - (index & MASK);
+        if (first > n)
+            first = n;
+        memcpy(dst, &slots[index & MASK], first * sizeof(T));
+        memcpy(dst + first, &slots[0], (n - first) * sizeof(T));
+    }
+
+    /**
+     * Adds n to a counter owned by the calling side (no read-modify-write atomics needed).
+     *
+     * @returns None
+     */
+    static void count(std::atomic<uint32_t> &counter, uint32_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * Producer: appends up to n elements.
+     *
+     * @param src Elements to append.
+     * @param n Number of elements.
+     *
+     * @returns uint32_t number of elements accepted (always n with RING_OVERWRITE_OLDEST)
+     */
+    uint32_t push(const T *src, uint32_t n) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        if (POLICY == RING_DROP_NEWEST) {
+            const uint32_t free_slots = CAPACITY - (h - tail.load(std::memory_order_acquire));
+            if (n > free_slots) {
+                count(rejected, n - free_slots);
+                n = free_slots;
+            }
+            copyIn(h, src, n);
+            head.store(h + n, std::memory_order_release);
+            return n;
+        }
+        // One element at a time, so the slot being written is always the one at head and the
+        // consumer's lap check covers it (the fence keeps the slot write after the head store, as in a seqlock)
+        for (uint32_t i = 0; i < n; i++) {
+            std::atomic_thread_fence(std::memory_order_release);
+            slots[(h + i) & MASK] = src[i];
+            head.store(h + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * Producer: appends one element.
+     *
+     * @returns True if the element was queued, False if it was dropped.
+     */
+    bool push(const T &value) {
+        return push(&value, 1) == 1;
+    }
+
+    /**
+     * Consumer: removes up to max elements, oldest first.
+     *
+     * @param dst Destination of at least max elements.
+     * @param max Maximum number of elements to remove.
+     *
+     * @returns uint32_t number of elements removed
+     */
+    uint32_t pop(T *dst, uint32_t max) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (POLICY == RING_OVERWRITE_OLDEST && h - t >= CAPACITY) {
+                // Lapped: the slot at h - CAPACITY may be in the middle of a write, start after it
+                count(overwritten, h - CAPACITY + 1 - t);
+                t = h - CAPACITY + 1;
+            }
+            uint32_t n = h - t;
+            if (n > max)
+                n = max;
+            copyOut(t, dst, n);
+            if (POLICY == RING_OVERWRITE_OLDEST) {
+                // Elements the producer may have overwritten while they were copied are discarded
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint32_t valid_from = head.load(std::memory_order_relaxed) - CAPACITY + 1;
+                int32_t stale = static_cast<int32_t>(valid_from - t);
+                if (stale > 0) {
+                    count(overwritten, stale);
+                    t += stale;
+                    if (static_cast<uint32_t>(stale) >= n)
+                        continue;
+                    n -= stale;
+                    memmove(dst, dst + stale, n * sizeof(T));
+                }
+            }
+            tail.store(t + n, std::memory_order_release);
+            return n;
+        }
+    }
+
+    /**
+     * Consumer: removes the oldest element.
+     *
+     * @returns True if an element was removed, False if the ring was empty.
+     */
+    bool pop(T &value) {
+        return pop(&value, 1) == 1;
+    }
+
+    /**
+     * Producer: contiguous free run for zero-copy writes, published with commitWrite().
+     *
+     * @param n Set to the length of the run, 0 if the ring is full.
+     *
+     * @returns T* start of the run
+     */
+    T *writeSpan(uint32_t &n) {
+        static_assert(POLICY == RING_DROP_NEWEST, "spans need RING_DROP_NEWEST");
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        const uint32_t free_slots = CAPACITY - (h - tail.load(std::memory_order_acquire));
+        const uint32_t run = CAPACITY - (h & MASK);
+        n = free_slots < run ? free_slots : run;
+        return &slots[h & MASK];
+    }
+
+    /**
+     * Producer: publishes n elements written through writeSpan().
+     *
+     * @returns None
+     */
+    void commitWrite(uint32_t n) {
+        head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * Consumer: contiguous run of queued elements for zero-copy reads, released with commitRead().
+     *
+     * @param n Set to the length of the run, 0 if the ring is empty.
+     *
+     * @returns const T* start of the run
+     */
+    const T *readSpan(uint32_t &n) const {
+        static_assert(POLICY == RING_DROP_NEWEST, "spans need RING_DROP_NEWEST");
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t used = head.load(std::memory_order_acquire) - t;
+        const uint32_t run = CAPACITY - (t & MASK);
+        n = used < run ? used : run;
+        return &slots[t & MASK];
+    }
+
+    /**
+     * Consumer: releases n elements read through readSpan().
+     *
+     * @returns None
+     */
+    void commitRead(uint32_t n) {
+        tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * Number of queued elements. Exact from the consumer, a snapshot from anywhere else; can exceed
+     * the capacity after a lap with RING_OVERWRITE_OLDEST until the consumer catches up.
+     *
+     * @returns uint32_t queued elements
+     */
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr uint32_t capacity() {
+        return CAPACITY;
+    }
+
+    /**
+     * Elements lost so far: rejected by push() with RING_DROP_NEWEST, skipped by pop() after being
+     * overwritten with RING_OVERWRITE_OLDEST.
+     *
+     * @returns uint32_t lost elements
+     */
+    uint32_t overruns() const {
+        return rejected.load(std::memory_order_relaxed) + overwritten.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "mbed.h"
+#include "hal/us_ticker_api.h"
+
+// Event types a scheduler can hold
+#define SCHEDULER_MAX_EVENTS 8
+
+/**
+ * @brief One kind of event (sensor ready, touch, redraw, ...) with its handler, priority, deadline and
+ *  latency statistics.
+ *
+ * An event is either pending or not: posting it again before it ran only moves its release time
+ * earlier and counts as coalesced, so no queue storage is needed and interrupts can post freely.
+ */
+class SchedulerEvent {
+public:
+    const char *name;
+    uint8_t priority;     // higher runs first
+    uint32_t deadline_us; // from release to the end of the handler
+    Callback<void()> handler;
+
+    // Scheduling state, shared with interrupts
+    volatile bool pending = false;
+    volatile uint32_t release_us = 0;
+
+    // Statistics, release to start is the latency
+    uint32_t runs = 0;
+    uint32_t misses = 0;
+    uint32_t coalesced = 0;
+    uint32_t worst_latency_us = 0;
+    uint64_t total_latency_us = 0;
+    uint32_t worst_run_us = 0;
+
+    /** CONSTRUCTOR
+     *
+     * @param _name Name used in the statistics.
+     * @param _priority Priority, higher values run first.
+     * @param _deadline_us Allowed time from release to completion.
+     * @param _handler Function run on dispatch.
+     *
+     * @returns None
+     */
+    SchedulerEvent(const char *_name, uint8_t _priority, uint32_t _deadline_us, Callback<void()> _handler)
+        : name(_name), priority(_priority), deadline_us(_deadline_us), handler(_handler) {}
+
+    /**
+     * Average latency from release to start.
+     *
+     * @returns uint32_t microseconds
+     */
+    uint32_t averageLatency() const {
+        return runs ? static_cast<uint32_t>(total_latency_us / runs) : 0;
+    }
+};
+
+/**
+ * @brief Cooperative, run-to-completion scheduler for the bare-metal build.
+ *
+ * dispatch() runs the ready event with the highest priority (earliest absolute deadline on ties). When
+ * nothing is ready it arms a Timeout for the next release and sleeps (WFI) until that or any other
+ * interrupt; the ready check and the sleep happen inside one critical section, so an interrupt that
+ * posts in between still wakes the core. Handlers must not block: long work delays everything behind
+ * it, which is exactly what the latency and deadline statistics show.
+ */
+class Scheduler {
+private:
+    SchedulerEvent *events[SCHEDULER_MAX_EVENTS];
+    uint32_t num_events = 0;
+    Timeout wakeup;
+
+    static void wake() {}
+
+    static int32_t diff(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b);
+    }
+
+public:
+    // Time spent asleep and number of sleeps since the last clearStats()
+    uint64_t idle_us = 0;
+    uint32_t sleeps = 0;
+    uint32_t stats_start_us = 0;
+
+    /**
+     * Registers an event type. Call before dispatching.
+     *
+     * @returns True if registered, False if the table is full.
+     */
+    bool add(SchedulerEvent &event) {
+        if (num_events >= SCHEDULER_MAX_EVENTS)
+            return false;
+        events[num_events++] = &event;
+        return true;
+    }
+
+    /**
+     * Makes an event ready after a delay. Safe from interrupts.
+     *
+     * @param event Registered event.
+     * @param delay_us Delay from now until release.
+     *
+     * @returns None
+     */
+    void post(SchedulerEvent &event, uint32_t delay_us = 0) {
+        postAt(event, us_ticker_read() + delay_us);
+    }
+
+    /**
+     * Makes an event ready at an absolute ticker time, e.g. one period after its last release for drift
+     * free periodic events. Safe from interrupts.
+     *
+     * @returns None
+     */
+    void postAt(SchedulerEvent &event, uint32_t release_us) {
+        core_util_critical_section_enter();
+        if (event.pending) {
+            event.coalesced++;
+            if (diff(release_us, event.release_us) < 0)
+                event.release_us = release_us;
+        } else {
+            event.release_us = release_us;
+            event.pending = true;
+        }
+        core_util_critical_section_exit();
+    }
+
+    /**
+     * Runs one ready event, or sleeps until the next release or interrupt.
+     *
+     * @returns True if an event ran, False if the core slept.
+     */
+    bool dispatch() {
+        core_util_critical_section_enter();
+        uint32_t now = us_ticker_read();
+        SchedulerEvent *best = nullptr;
+        SchedulerEvent *next = nullptr;
+        for (uint32_t i = 0; i < num_events; i++) {
+            SchedulerEvent *e = events[i];
+            if (!e->pending)
+                continue;
+            if (diff(e->release_us, now) > 0) {
+                if (next == nullptr || diff(e->release_us, next->release_us) < 0)
+                    next = e;
+                continue;
+            }
+            if (best == nullptr || e->priority > best->priority ||
+                (e->priority == best->priority &&
+                 diff(e->release_us + e->deadline_us, best->release_us + best->deadline_us) < 0))
+                best = e;
+        }
+
+        if (best == nullptr) {
+            if (next != nullptr)
+                wakeup.attach(&Scheduler::wake, std::chrono::microseconds(diff(next->release_us, now)));
+            sleep_manager_sleep_auto();
+            idle_us += us_ticker_read() - now;
+            sleeps++;
+            core_util_critical_section_exit();
+            return false;
+        }
+        best->pending = false;
+        uint32_t release = best->release_us;
+        core_util_critical_section_exit();
+
+        uint32_t start = us_ticker_read();
+        best->handler();
+        uint32_t end = us_ticker_read();
+
+        uint32_t latency = start - release;
+        uint32_t run = end - start;
+        best->runs++;
+        best->total_latency_us += latency;
+        if (latency > best->worst_latency_us)
+            best->worst_latency_us = latency;
+        if (run > best->worst_run_us)
+            best->worst_run_us = run;
+        if (end - release > best->deadline_us)
+            best->misses++;
+        return true;
+    }
+
+    /**
+     * Dispatches forever.
+     *
+     * @returns None, never returns
+     */
+    void run() {
+        while (true) {
+            dispatch();
+        }
+    }
+
+    /**
+     * Prints latency, run time and deadline misses of every event and the idle share over serial.
+     *
+     * @returns None
+     */
+    void printStats() {
+        uint32_t elapsed = us_ticker_read() - stats_start_us;
+        for (uint32_t i = 0; i < num_events; i++) {
+            const SchedulerEvent *e = events[i];
+            printf("Events: %-7s prio %u runs %lu latency avg %lu max %lu us, run max %lu us, misses %lu (deadline %lu us), coalesced %lu\n",
+                   e->name, e->priority, e->runs, e->averageLatency(), e->worst_latency_us, e->worst_run_us,
+                   e->misses, e->deadline_us, e->coalesced);
+        }
+        printf("Events: idle %.1f%% over %lu sleeps\n", elapsed ? 100.0f * idle_us / elapsed : 0.0f, sleeps);
+    }
+
+    /**
+     * Restarts all statistics.
+     *
+     * @returns None
+     */
+    void clearStats() {
+        for (uint32_t i = 0; i < num_events; i++) {
+            SchedulerEvent *e = events[i];
+            e->runs = e->misses = e->coalesced = 0;
+            e->worst_latency_us = e->worst_run_us = 0;
+            e->total_latency_us = 0;
+        }
+        idle_us = 0;
+        sleeps = 0;
+        stats_start_us = us_ticker_read();
+    }
+};
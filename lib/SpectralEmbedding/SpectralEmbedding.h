@@ -0,0 +1,115 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Window length fed to the embedding (must match an arm_mfcc_init_<N>_f32 size)
+#define EMBEDDING_FFT_SIZE 256
+// Triangular filters spread linearly over 0 hz .. EMBEDDING_MAX_HZ
+#define EMBEDDING_FILTERS 16
+#define EMBEDDING_MAX_HZ 16.0f
+// Number of cepstral coefficients kept per window
+#define EMBEDDING_SIZE 12
+
+/**
+ * @brief Reduces a window of gyroscope samples to a handful of cepstral coefficients
+ *  (MFCC style, but with a linear filterbank tuned to 0-16 hz instead of the mel scale).
+ *
+ * 256 magnitude bins become EMBEDDING_SIZE floats, which is what gets logged and fed to the
+ * classifier. The filterbank, DCT matrix and window are built once in the constructor,
+ * arm_mfcc_f32 does the rest.
+ */
+class SpectralEmbedding {
+private:
+    arm_mfcc_instance_f32 mfcc;
+
+    float32_t window_coefs[EMBEDDING_FFT_SIZE];
+    float32_t dct_coefs[EMBEDDING_SIZE * EMBEDDING_FILTERS];
+    uint32_t filter_pos[EMBEDDING_FILTERS];
+    uint32_t filter_lengths[EMBEDDING_FILTERS];
+    // Each triangle spans at most two filter spacings, bounded by half the spectrum
+    float32_t filter_coefs[EMBEDDING_FFT_SIZE];
+
+    // arm_mfcc_f32 works in place on the input and needs a complex scratch buffer
+    float32_t samples[EMBEDDING_FFT_SIZE];
+    float32_t scratch[EMBEDDING_FFT_SIZE * 2];
+
+public:
+    float32_t coefficients[EMBEDDING_SIZE] = {0};
+
+    /** CONSTRUCTOR
+     * Builds the Hann window, the triangular filterbank and the DCT-II matrix.
+     *
+     * @param sample_rate_hz Sampling rate of the input window in hz.
+     *
+     * @returns None
+     */
+    SpectralEmbedding(float32_t sample_rate_hz) {
+        // Hann window
+        for (uint32_t i = 0; i < EMBEDDING_FFT_SIZE; i++) {
+            window_coefs[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / EMBEDDING_FFT_SIZE);
+        }
+
+        // Triangular filters with centers evenly spaced over (0, EMBEDDING_MAX_HZ)
+        float32_t bin_hz = sample_rate_hz / EMBEDDING_FFT_SIZE;
+        float32_t max_hz = EMBEDDING_MAX_HZ < sample_rate_hz / 2.0f ? EMBEDDING_MAX_HZ : sample_rate_hz / 2.0f;
+        float32_t spacing = max_hz / (EMBEDDING_FILTERS + 1);
+        uint32_t coef = 0;
+        for (uint32_t f = 0; f < EMBEDDING_FILTERS; f++) {
+            float32_t left = f * spacing;
+            float32_t center = (f + 1) * spacing;
+            float32_t right = (f + 2) * spacing;
+            uint32_t first = static_cast<uint32_t>(ceilf(left / bin_hz));
+            uint32_t last = static_cast<uint32_t>(floorf(right / bin_hz));
+            if (last > EMBEDDING_FFT_SIZE / 2)
+                last = EMBEDDING_FFT_SIZE / 2;
+
+            filter_pos[f] = first;
+            filter_lengths[f] = 0;
+            for (uint32_t bin = first; bin <= last && coef < EMBEDDING_FFT_SIZE; bin++) {
+                float32_t freq = bin * bin_hz;
+                float32_t weight = freq <= center ? (freq - left) / (center - left) : (right - freq) / (right - center);
+                filter_coefs[coef++] = weight > 0.0f ? weight : 0.0f;
+                filter_lengths[f]++;
+            }
+        }
+
+        // Orthonormal DCT-II, keeping the first EMBEDDING_SIZE rows
+        for (uint32_t k = 0; k < EMBEDDING_SIZE; k++) {
+            float32_t scale = k == 0 ? sqrtf(1.0f / EMBEDDING_FILTERS) : sqrtf(2.0f / EMBEDDING_FILTERS);
+            for (uint32_t m = 0; m < EMBEDDING_FILTERS; m++) {
+                dct_coefs[k * EMBEDDING_FILTERS + m] = scale * cosf(PI / EMBEDDING_FILTERS * (m + 0.5f) * k);
+            }
+        }
+
+        arm_mfcc_init_256_f32(&mfcc, EMBEDDING_FILTERS, EMBEDDING_SIZE, dct_coefs, filter_pos, filter_lengths, filter_coefs, window_coefs);
+    }
+
+    /**
+     * Computes the embedding of one window.
+     *
+     * @param input Real samples, EMBEDDING_FFT_SIZE long, read with the given stride
+     *  (use stride 2 to read the real part of an interleaved complex buffer).
+     * @param stride Distance between consecutive samples in input.
+     *
+     * @returns Pointer to the EMBEDDING_SIZE coefficients.
+     */
+    const float32_t* compute(const float32_t *input, uint32_t stride = 1) {
+        for (uint32_t i = 0; i < EMBEDDING_FFT_SIZE; i++) {
+            samples[i] = input[i * stride];
+        }
+        arm_mfcc_f32(&mfcc, samples, coefficients, scratch);
+        return coefficients;
+    }
+
+    /**
+     * Euclidean distance between two embeddings, for template matching.
+     *
+     * @param a First embedding of EMBEDDING_SIZE floats.
+     * @param b Second embedding of EMBEDDING_SIZE floats.
+     *
+     * @returns float distance
+     */
+    static float32_t distance(const float32_t *a, const float32_t *b) {
+        return arm_euclidean_distance_f32(a, b, EMBEDDING_SIZE);
+    }
+};
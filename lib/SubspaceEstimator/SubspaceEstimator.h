@@ -0,0 +1,173 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Order of the autocorrelation matrix; caps the cost of every stage, so the worst case is known:
+// n * order MACs for the lags, then SUBSPACE_ITERATIONS * (2 order^2 MACs + one order x 2 QR)
+#define SUBSPACE_MAX_ORDER 8
+// A real sinusoid spans two dimensions (e^{+jw}, e^{-jw})
+#define SUBSPACE_RANK 2
+// Orthogonal iterations per estimate, warm started from the previous window's subspace
+#define SUBSPACE_ITERATIONS 6
+// Householder threshold passed to arm_mat_qr_f32
+#define SUBSPACE_QR_THRESHOLD 1e-7f
+// Initial guess for the signal subspace, centre of the tremor band
+#define SUBSPACE_START_HZ 4.5f
+
+/**
+ * @brief ESPRIT frequency estimator for one dominant sinusoid in a short, band-passed window.
+ *
+ * The window's autocorrelation lags form a small Toeplitz matrix R. Its two dominant eigenvectors
+ * are found by orthogonal iteration (arm_mat_mult_f32 + arm_mat_qr_f32), then the rotational
+ * invariance U2 = U1 Phi is solved in the least squares sense through the normal equations
+ * (arm_mat_cholesky_f32 + triangular solves). The eigenvalues of the 2x2 Phi are e^{+-jw}, so the
+ * frequency needs no FFT grid and stays accurate on windows far shorter than the FFT's.
+ */
+class SubspaceEstimator {
+private:
+    uint32_t order;
+    float32_t hz_per_radian;
+
+    float32_t lags[SUBSPACE_MAX_ORDER];
+    float32_t corr_data[SUBSPACE_MAX_ORDER * SUBSPACE_MAX_ORDER];
+    float32_t basis_data[SUBSPACE_MAX_ORDER * SUBSPACE_RANK];
+    float32_t product_data[SUBSPACE_MAX_ORDER * SUBSPACE_RANK];
+    float32_t qr_r_data[SUBSPACE_MAX_ORDER * SUBSPACE_RANK];
+    float32_t qr_q_data[SUBSPACE_MAX_ORDER * SUBSPACE_MAX_ORDER];
+    float32_t tau[SUBSPACE_RANK];
+    float32_t tmp_a[SUBSPACE_MAX_ORDER];
+    float32_t tmp_b[SUBSPACE_MAX_ORDER];
+
+    // 2x2 working matrices of the ESPRIT solve
+    float32_t u1t_data[SUBSPACE_RANK * (SUBSPACE_MAX_ORDER - 1)];
+    float32_t gram_data[SUBSPACE_RANK * SUBSPACE_RANK];
+    float32_t cross_data[SUBSPACE_RANK * SUBSPACE_RANK];
+    float32_t chol_data[SUBSPACE_RANK * SUBSPACE_RANK];
+    float32_t chol_t_data[SUBSPACE_RANK * SUBSPACE_RANK];
+    float32_t half_data[SUBSPACE_RANK * SUBSPACE_RANK];
+    float32_t phi_data[SUBSPACE_RANK * SUBSPACE_RANK];
+
+    arm_matrix_instance_f32 corr, basis, product, qr_r, qr_q;
+    arm_matrix_instance_f32 u1, u2, u1t, gram, cross, chol, chol_t, half, phi;
+
+public:
+    // Results of the last estimate
+    float32_t frequency = 0.0f;       // hz, 0 if no oscillatory pair was found
+    float32_t signal_fraction = 0.0f; // share of the window power in the two dominant eigenvectors
+
+    /** CONSTRUCTOR
+     *
+     * @param sample_rate_hz Sampling rate of the input in hz.
+     * @param matrix_order Order of the autocorrelation matrix, clamped to [3, SUBSPACE_MAX_ORDER].
+     *
+     * @returns None
+     */
+    SubspaceEstimator(float32_t sample_rate_hz, uint32_t matrix_order = SUBSPACE_MAX_ORDER)
+        : order(matrix_order < 3 ? 3 : (matrix_order > SUBSPACE_MAX_ORDER ? SUBSPACE_MAX_ORDER : matrix_order)),
+          hz_per_radian(sample_rate_hz / (2.0f * PI)) {
+        arm_mat_init_f32(&corr, order, order, corr_data);
+        arm_mat_init_f32(&basis, order, SUBSPACE_RANK, basis_data);
+        arm_mat_init_f32(&product, order, SUBSPACE_RANK, product_data);
+        arm_mat_init_f32(&qr_r, order, SUBSPACE_RANK, qr_r_data);
+        arm_mat_init_f32(&qr_q, order, order, qr_q_data);
+        // The shift invariant halves of the basis are its first and last order - 1 rows
+        arm_mat_init_f32(&u1, order - 1, SUBSPACE_RANK, basis_data);
+        arm_mat_init_f32(&u2, order - 1, SUBSPACE_RANK, basis_data + SUBSPACE_RANK);
+        arm_mat_init_f32(&u1t, SUBSPACE_RANK, order - 1, u1t_data);
+        arm_mat_init_f32(&gram, SUBSPACE_RANK, SUBSPACE_RANK, gram_data);
+        arm_mat_init_f32(&cross, SUBSPACE_RANK, SUBSPACE_RANK, cross_data);
+        arm_mat_init_f32(&chol, SUBSPACE_RANK, SUBSPACE_RANK, chol_data);
+        arm_mat_init_f32(&chol_t, SUBSPACE_RANK, SUBSPACE_RANK, chol_t_data);
+        arm_mat_init_f32(&half, SUBSPACE_RANK, SUBSPACE_RANK, half_data);
+        arm_mat_init_f32(&phi, SUBSPACE_RANK, SUBSPACE_RANK, phi_data);
+        reset(sample_rate_hz);
+    }
+
+    /**
+     * Forgets the warm start and seeds the subspace with a sinusoid at SUBSPACE_START_HZ.
+     *
+     * @param sample_rate_hz Sampling rate of the input in hz.
+     *
+     * @returns None
+     */
+    void reset(float32_t sample_rate_hz) {
+        const float32_t w = 2.0f * PI * SUBSPACE_START_HZ / sample_rate_hz;
+        for (uint32_t i = 0; i < order; i++) {
+            basis_data[i * SUBSPACE_RANK] = cosf(w * i);
+            basis_data[i * SUBSPACE_RANK + 1] = sinf(w * i);
+        }
+    }
+
+    /**
+     * Estimates the dominant frequency of a band-passed window.
+     *
+     * @param x Zero mean (band-passed) samples.
+     * @param n Number of samples, at least twice the matrix order.
+     *
+     * @returns float frequency in hz, 0 if the window holds no oscillation
+     */
+    float32_t estimate(const float32_t *x, uint32_t n) {
+        frequency = 0.0f;
+        signal_fraction = 0.0f;
+        if (n < 2 * order)
+            return 0.0f;
+
+        // Biased autocorrelation, always gives a positive semi-definite Toeplitz matrix
+        for (uint32_t k = 0; k < order; k++) {
+            arm_dot_prod_f32(x, x + k, n - k, &lags[k]);
+            lags[k] /= n;
+        }
+        if (lags[0] <= 0.0f)
+            return 0.0f;
+        for (uint32_t i = 0; i < order; i++) {
+            for (uint32_t j = 0; j < order; j++) {
+                corr_data[i * order + j] = lags[i > j ? i - j : j - i];
+            }
+        }
+
+        // Orthogonal iteration: basis <- first two columns of Q in qr(R basis)
+        for (uint32_t it = 0; it < SUBSPACE_ITERATIONS; it++) {
+            arm_mat_mult_f32(&corr, &basis, &product);
+            if (arm_mat_qr_f32(&product, SUBSPACE_QR_THRESHOLD, &qr_r, &qr_q, tau, tmp_a, tmp_b) != ARM_MATH_SUCCESS)
+                return 0.0f;
+            for (uint32_t i = 0; i < order; i++) {
+                basis_data[i * SUBSPACE_RANK] = qr_q_data[i * order];
+                basis_data[i * SUBSPACE_RANK + 1] = qr_q_data[i * order + 1];
+            }
+        }
+
+        // Rayleigh quotients of the orthonormal basis give the two dominant eigenvalues
+        arm_mat_mult_f32(&corr, &basis, &product);
+        float32_t dominant = 0.0f;
+        for (uint32_t i = 0; i < order * SUBSPACE_RANK; i++) {
+            dominant += basis_data[i] * product_data[i];
+        }
+        signal_fraction = dominant / (order * lags[0]);
+
+        // Least squares U1 Phi = U2 via (U1^T U1) Phi = U1^T U2, U1^T U1 = L L^T
+        arm_mat_trans_f32(&u1, &u1t);
+        arm_mat_mult_f32(&u1t, &u1, &gram);
+        arm_mat_mult_f32(&u1t, &u2, &cross);
+        if (arm_mat_cholesky_f32(&gram, &chol) != ARM_MATH_SUCCESS)
+            return 0.0f;
+        chol_data[1] = 0.0f; // upper triangle is left untouched by the decomposition
+        arm_mat_trans_f32(&chol, &chol_t);
+        if (arm_mat_solve_lower_triangular_f32(&chol, &cross, &half) != ARM_MATH_SUCCESS)
+            return 0.0f;
+        if (arm_mat_solve_upper_triangular_f32(&chol_t, &half, &phi) != ARM_MATH_SUCCESS)
+            return 0.0f;
+
+        // Eigenvalues of Phi: tr/2 +- sqrt(tr^2/4 - det), a complex pair at angle +-w
+        float32_t half_trace = 0.5f * (phi_data[0] + phi_data[3]);
+        float32_t det = phi_data[0] * phi_data[3] - phi_data[1] * phi_data[2];
+        float32_t disc = det - half_trace * half_trace;
+        if (disc <= 0.0f)
+            return 0.0f;
+        float32_t imag;
+        arm_sqrt_f32(disc, &imag);
+        float32_t w;
+        arm_atan2_f32(imag, half_trace, &w);
+        frequency = w * hz_per_radian;
+        return frequency;
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Smoothing of the energy operator outputs (exponential, in samples)
+#define TKEO_SMOOTHING_SAMPLES 8.0f
+
+/**
+ * @brief Teager-Kaiser energy operator with the DESA-2 energy separation algorithm.
+ *
+ * Estimates instantaneous frequency and amplitude of a band-passed oscillation from five
+ * consecutive samples, with a handful of multiplies per sample and no transform buffer:
+ *   psi(x[n]) = x[n]^2 - x[n-1] x[n+1],  y[n] = x[n+1] - x[n-1]
+ *   omega = 0.5 acos(1 - psi(y) / (2 psi(x))),  A = 2 psi(x) / sqrt(psi(y))
+ * The outputs lag the input by two samples.
+ */
+class TeagerKaiser {
+private:
+    float32_t x[5] = {0}; // x[n-4] .. x[n]
+    float32_t smoothing;
+    float32_t psi_x = 0.0f;
+    float32_t psi_y = 0.0f;
+    float32_t hz_per_radian;
+
+    // Window averages, the ratio of averages is far more robust than averaging ratios
+    float32_t window_psi_x = 0.0f;
+    float32_t window_psi_y = 0.0f;
+    uint32_t window_samples = 0;
+
+    /**
+     * Applies DESA-2 to a pair of energy values.
+     *
+     * @returns float frequency in hz, amplitude through the pointer
+     */
+    float32_t separate(float32_t energy_x, float32_t energy_y, float32_t *amp) {
+        if (energy_x <= 0.0f || energy_y <= 0.0f) {
+            *amp = 0.0f;
+            return 0.0f;
+        }
+        float32_t c = 1.0f - energy_y / (2.0f * energy_x);
+        c = c > 1.0f ? 1.0f : (c < -1.0f ? -1.0f : c);
+        float32_t root;
+        arm_sqrt_f32(energy_y, &root);
+        *amp = 2.0f * energy_x / root;
+        return 0.5f * acosf(c) * hz_per_radian;
+    }
+
+public:
+    // Latest per-sample outputs
+    float32_t frequency = 0.0f; // hz
+    float32_t amplitude = 0.0f; // input units
+    // Estimate over the last completed window
+    float32_t window_frequency = 0.0f;
+    float32_t window_amplitude = 0.0f;
+
+    /** CONSTRUCTOR
+     *
+     * @param sample_rate_hz Sampling rate of the input in hz.
+     *
+     * @returns None
+     */
+    TeagerKaiser(float32_t sample_rate_hz) : smoothing(1.0f / TKEO_SMOOTHING_SAMPLES), hz_per_radian(sample_rate_hz / (2.0f * PI)) {}
+
+    /**
+     * Processes one band-passed sample.
+     *
+     * @param sample Band-passed input sample.
+     *
+     * @returns float instantaneous frequency estimate in hz
+     */
+    float32_t update(float32_t sample) {
+        x[0] = x[1];
+        x[1] = x[2];
+        x[2] = x[3];
+        x[3] = x[4];
+        x[4] = sample;
+
+        // Energy of x and of its symmetric difference, both centred on x[2]
+        float32_t ex = x[2] * x[2] - x[1] * x[3];
+        float32_t y_prev = x[2] - x[0];
+        float32_t y = x[3] - x[1];
+        float32_t y_next = x[4] - x[2];
+        float32_t ey = y * y - y_prev * y_next;
+
+        psi_x += smoothing * (ex - psi_x);
+        psi_y += smoothing * (ey - psi_y);
+        frequency = separate(psi_x, psi_y, &amplitude);
+
+        window_psi_x += ex;
+        window_psi_y += ey;
+        window_samples++;
+        return frequency;
+    }
+
+    /**
+     * Latches the window estimate and starts a new window.
+     *
+     * @returns float window frequency estimate in hz
+     */
+    float32_t endWindow() {
+        if (window_samples > 0)
+            window_frequency = separate(window_psi_x / window_samples, window_psi_y / window_samples, &window_amplitude);
+        window_psi_x = 0.0f;
+        window_psi_y = 0.0f;
+        window_samples = 0;
+        return window_frequency;
+    }
+};
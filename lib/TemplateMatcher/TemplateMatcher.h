@@ -0,0 +1,203 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Samples per template / query (~1.4 s at 33.3 hz, at least four periods of a 3 hz tremor)
+#define DTW_TEMPLATE_LEN 48
+// Sakoe-Chiba band half width in samples, bounds the warping and the cost per comparison
+#define DTW_BAND 4
+#define DTW_BAND_WIDTH (2 * DTW_BAND + 1)
+// Band-pass centre and quality factor applied before matching (passes roughly 2-8 hz)
+#define DTW_BANDPASS_HZ 4.0f
+#define DTW_BANDPASS_Q 0.7f
+// Normalized DTW distance above which the best template is not considered a match
+#define DTW_MATCH_THRESHOLD 0.3f
+
+// Template library generated by tools/gen_templates.py (see src/tremor_templates.c)
+extern "C" {
+    extern const uint32_t dtw_template_count;
+    extern const float32_t dtw_template_freqs[];
+    extern const uint8_t dtw_template_is_tremor[];
+    extern const float32_t dtw_templates[];
+}
+
+/**
+ * @brief Matches the band-passed gyroscope window against a flash-resident library of
+ *  tremor signatures using dynamic time warping constrained to a Sakoe-Chiba band.
+ *
+ * The DTW only visits the cells inside the band and keeps two rows of the band instead of the full
+ * cost matrix, so a comparison costs O(N * band) time and O(band) memory. The recursion and the
+ * normalization are the ones of arm_dtw_distance_f32 (diagonal steps weigh twice, the path cost is
+ * divided by the summed lengths), so distances and DTW_MATCH_THRESHOLD are unchanged.
+ */
+class TemplateMatcher {
+private:
+    arm_biquad_casd_df1_inst_f32 bandpass;
+    float32_t bandpass_coefs[5];
+    float32_t bandpass_state[4];
+
+    float32_t tail[DTW_TEMPLATE_LEN * 2];
+    float32_t query[DTW_TEMPLATE_LEN];
+
+    // Accumulated costs of the previous and the current query row, indexed by t - q + DTW_BAND
+    float32_t previous_row[DTW_BAND_WIDTH];
+    float32_t current_row[DTW_BAND_WIDTH];
+
+    /**
+     * Banded DTW distance between the prepared query and one template.
+     *
+     * @param tmpl DTW_TEMPLATE_LEN template samples.
+     *
+     * @returns float32_t path cost divided by the summed lengths
+     */
+    float32_t bandedDistance(const float32_t *tmpl) {
+        float32_t *previous = previous_row;
+        float32_t *current = current_row;
+        for (int32_t j = 0; j < DTW_BAND_WIDTH; j++) {
+            previous[j] = F32_MAX;
+        }
+        for (int32_t q = 0; q < DTW_TEMPLATE_LEN; q++) {
+            int32_t first = q - DTW_BAND < 0 ? 0 : q - DTW_BAND;
+            int32_t last = q + DTW_BAND >= DTW_TEMPLATE_LEN ? DTW_TEMPLATE_LEN - 1 : q + DTW_BAND;
+            for (int32_t j = 0; j < DTW_BAND_WIDTH; j++) {
+                current[j] = F32_MAX;
+            }
+            for (int32_t t = first; t <= last; t++) {
+                int32_t j = t - q + DTW_BAND;
+                float32_t d = fabsf(query[q] - tmpl[t]);
+                if (q == 0 && t == 0) {
+                    current[j] = d;
+                    continue;
+                }
+                // Cells outside the band stay at F32_MAX, as in arm_dtw_distance_f32
+                float32_t diagonal = previous[j] + 2.0f * d;
+                float32_t horizontal = j > 0 ? current[j - 1] + d : F32_MAX;
+                float32_t vertical = j < DTW_BAND_WIDTH - 1 ? previous[j + 1] + d : F32_MAX;
+                float32_t best = diagonal < horizontal ? diagonal : horizontal;
+                current[j] = best < vertical ? best : vertical;
+            }
+            float32_t *swap = previous;
+            previous = current;
+            current = swap;
+        }
+        // The last cell sits on the diagonal of the band
+        return previous[DTW_BAND] / (2 * DTW_TEMPLATE_LEN);
+    }
+
+public:
+    // Result of the last match()
+    int32_t best_template = -1;
+    float32_t best_distance = F32_MAX;
+
+    /** CONSTRUCTOR
+     * Designs the band-pass filter.
+     *
+     * @param sample_rate_hz Sampling rate of the gyroscope stream in hz.
+     *
+     * @returns None
+     */
+    TemplateMatcher(float32_t sample_rate_hz) {
+        // RBJ band-pass (constant 0 dB peak gain), CMSIS expects {b0, b1, b2, -a1, -a2} / a0
+        float32_t w0 = 2.0f * PI * DTW_BANDPASS_HZ / sample_rate_hz;
+        float32_t alpha = sinf(w0) / (2.0f * DTW_BANDPASS_Q);
+        float32_t a0 = 1.0f + alpha;
+        bandpass_coefs[0] = alpha / a0;
+        bandpass_coefs[1] = 0.0f;
+        bandpass_coefs[2] = -alpha / a0;
+        bandpass_coefs[3] = 2.0f * cosf(w0) / a0;
+        bandpass_coefs[4] = -(1.0f - alpha) / a0;
+        arm_biquad_cascade_df1_init_f32(&bandpass, 1, bandpass_coefs, bandpass_state);
+    }
+
+    /**
+     * Band-passes a window of samples and extracts the query: the last DTW_TEMPLATE_LEN
+     * samples starting on a rising zero crossing, normalized to zero mean and unit RMS so
+     * matching ignores amplitude and phase. The input is left untouched.
+     *
+     * @param samples Window of real samples, read with the given stride.
+     * @param num_samples Number of samples in the window (at least 2 * DTW_TEMPLATE_LEN).
+     * @param stride Distance between consecutive samples (2 for an interleaved complex buffer).
+     *
+     * @returns None
+     */
+    void prepareQuery(const float32_t *samples, uint32_t num_samples, uint32_t stride = 1) {
+        // Run the filter over the whole window, keeping only the tail that can hold the query
+        uint32_t tail_start = num_samples - 2 * DTW_TEMPLATE_LEN;
+        memset(bandpass_state, 0, sizeof(bandpass_state));
+        for (uint32_t i = 0; i < num_samples; i++) {
+            float32_t in = samples[i * stride];
+            float32_t out;
+            arm_biquad_cascade_df1_f32(&bandpass, &in, &out, 1);
+            if (i >= tail_start)
+                tail[i - tail_start] = out;
+        }
+
+        // Search for a rising zero crossing late in the window, once the filter has settled
+        uint32_t start = DTW_TEMPLATE_LEN;
+        for (uint32_t i = DTW_TEMPLATE_LEN / 2; i < DTW_TEMPLATE_LEN; i++) {
+            if (tail[i] <= 0.0f && tail[i + 1] > 0.0f) {
+                start = i + 1;
+                break;
+            }
+        }
+
+        float32_t mean, rms;
+        arm_mean_f32(&tail[start], DTW_TEMPLATE_LEN, &mean);
+        arm_offset_f32(&tail[start], -mean, query, DTW_TEMPLATE_LEN);
+        arm_rms_f32(query, DTW_TEMPLATE_LEN, &rms);
+        if (rms > 0.0f)
+            arm_scale_f32(query, 1.0f / rms, query, DTW_TEMPLATE_LEN);
+    }
+
+    /**
+     * Compares the prepared query against every template in the library.
+     *
+     * @returns int32_t index of the closest template, or -1 if the library is empty
+     */
+    int32_t match() {
+        best_template = -1;
+        best_distance = F32_MAX;
+
+        for (uint32_t t = 0; t < dtw_template_count; t++) {
+            float32_t distance = bandedDistance(&dtw_templates[t * DTW_TEMPLATE_LEN]);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_template = t;
+            }
+        }
+        return best_template;
+    }
+
+    /**
+     * Frequency of the best matching template.
+     *
+     * @returns float frequency in hz, 0 if nothing matched
+     */
+    float32_t matchedFrequency() {
+        return best_distance > DTW_MATCH_THRESHOLD ? 0.0f : dtw_template_freqs[best_template];
+    }
+
+    /**
+     * Whether the best matching template is a tremor signature.
+     *
+     * @returns bool
+     */
+    bool matchedTremor() {
+        return best_distance <= DTW_MATCH_THRESHOLD && dtw_template_is_tremor[best_template];
+    }
+
+    /**
+     * Number of DTW cells evaluated per template, the whole cost of a comparison.
+     *
+     * @returns uint32_t cells inside the Sakoe-Chiba band
+     */
+    static uint32_t bandCells() {
+        uint32_t cells = 0;
+        for (int32_t q = 0; q < DTW_TEMPLATE_LEN; q++) {
+            int32_t first = q - DTW_BAND < 0 ? 0 : q - DTW_BAND;
+            int32_t last = q + DTW_BAND >= DTW_TEMPLATE_LEN ? DTW_TEMPLATE_LEN - 1 : q + DTW_BAND;
+            cells += last - first + 1;
+        }
+        return cells;
+    }
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "arm_math.h"
+
+// Tremor band edges used to isolate the oscillation before integration
+#define AMPLITUDE_HIGHPASS_HZ 2.0f
+#define AMPLITUDE_LOWPASS_HZ 8.0f
+// Time constant of the leaky integrator, long compared to a tremor period but short enough
+// that any residual offset cannot build up into drift
+#define AMPLITUDE_LEAK_SECONDS 1.0f
+
+#define RAD_TO_DEG 57.295779513f
+
+/**
+ * @brief 2-8 hz band-pass (2nd order Butterworth high-pass and low-pass sections) with its own state.
+ *
+ */
+class TremorBandpass {
+private:
+    arm_biquad_casd_df1_inst_f32 bandpass;
+    float32_t bandpass_coefs[10];
+    float32_t bandpass_state[8];
+
+public:
+    /** CONSTRUCTOR
+     * Designs the band-pass for the given rate.
+     *
+     * @param sample_rate_hz Sampling rate of the filtered stream in hz.
+     *
+     * @returns None
+     */
+    TremorBandpass(float32_t sample_rate_hz) {
+        const float32_t q = 0.70710678f;
+
+        // RBJ high-pass, CMSIS expects {b0, b1, b2, -a1, -a2} / a0
+        float32_t w0 = 2.0f * PI * AMPLITUDE_HIGHPASS_HZ / sample_rate_hz;
+        float32_t alpha = sinf(w0) / (2.0f * q);
+        float32_t cw = cosf(w0);
+        float32_t a0 = 1.0f + alpha;
+        bandpass_coefs[0] = (1.0f + cw) / 2.0f / a0;
+        bandpass_coefs[1] = -(1.0f + cw) / a0;
+        bandpass_coefs[2] = (1.0f + cw) / 2.0f / a0;
+        bandpass_coefs[3] = 2.0f * cw / a0;
+        bandpass_coefs[4] = -(1.0f - alpha) / a0;
+
+        // RBJ low-pass
+        w0 = 2.0f * PI * AMPLITUDE_LOWPASS_HZ / sample_rate_hz;
+        alpha = sinf(w0) / (2.0f * q);
+        cw = cosf(w0);
+        a0 = 1.0f + alpha;
+        bandpass_coefs[5] = (1.0f - cw) / 2.0f / a0;
+        bandpass_coefs[6] = (1.0f - cw) / a0;
+        bandpass_coefs[7] = (1.0f - cw) / 2.0f / a0;
+        bandpass_coefs[8] = 2.0f * cw / a0;
+        bandpass_coefs[9] = -(1.0f - alpha) / a0;
+
+        arm_biquad_cascade_df1_init_f32(&bandpass, 2, bandpass_coefs, bandpass_state);
+    }
+
+    /**
+     * Filters a block, the state carries over to the next call.
+     *
+     * @param input Input samples.
+     * @param output Output samples, may be the input buffer.
+     * @param n Number of samples.
+     *
+     * @returns None
+     */
+    void process(const float32_t *input, float32_t *output, uint32_t n) {
+        arm_biquad_cascade_df1_f32(&bandpass, input, output, n);
+    }
+
+    /**
+     * Clears the filter state, for a stream that resumes after a gap. The next block starts from rest
+     * instead of continuing the previous block's tail.
+     *
+     * @returns None
+     */
+    void reset() {
+        arm_fill_f32(0.0f, bandpass_state, 8);
+    }
+};
+
+/**
+ * @brief Streaming tremor amplitude estimator: band-passes angular velocity and integrates it
+ *  into rotation angle with a leaky (high-pass) integrator.
+ *
+ * Call update() once per sample (fixed cost: two biquad sections and a few multiplies) and
+ * endWindow() once per analysis window to latch peak-to-peak rotation and band RMS.
+ */
+class TremorAmplitude {
+private:
+    TremorBandpass bandpass;
+
+    float32_t dt;
+    float32_t leak;
+    float32_t angle = 0.0f;
+
+    float32_t angle_min = 0.0f;
+    float32_t angle_max = 0.0f;
+    float32_t sum_squares = 0.0f;
+    uint32_t samples = 0;
+
+public:
+    // Latest band-passed angular velocity (rad/s), for stages that share the filter
+    float32_t band = 0.0f;
+    // Results of the last completed window
+    float32_t peak_to_peak_deg = 0.0f;
+    float32_t band_rms = 0.0f; // rad/s
+
+    /** CONSTRUCTOR
+     * Designs the band-pass and the leaky integrator.
+     *
+     * @param sample_rate_hz Sampling rate of the gyroscope stream in hz.
+     *
+     * @returns None
+     */
+    TremorAmplitude(float32_t sample_rate_hz) : bandpass(sample_rate_hz), dt(1.0f / sample_rate_hz) {
+        leak = expf(-dt / AMPLITUDE_LEAK_SECONDS);
+    }
+
+    /**
+     * Processes one angular velocity sample.
+     *
+     * @param velocity Angular velocity in rad/s.
+     *
+     * @returns float current rotation angle estimate in degrees
+     */
+    float32_t update(float32_t velocity) {
+        bandpass.process(&velocity, &band, 1);
+
+        angle = leak * angle + band * dt;
+
+        if (samples == 0) {
+            angle_min = angle;
+            angle_max = angle;
+        }
+        else if (angle < angle_min)
+            angle_min = angle;
+        else if (angle > angle_max)
+            angle_max = angle;
+        sum_squares += band * band;
+        samples++;
+
+        return angle * RAD_TO_DEG;
+    }
+
+    /**
+     * Latches the statistics of the current window and starts a new one. The filter and
+     * integrator states carry over so consecutive windows stay continuous.
+     *
+     * @returns None
+     */
+    void endWindow() {
+        if (samples > 0) {
+            peak_to_peak_deg = (angle_max - angle_min) * RAD_TO_DEG;
+            arm_sqrt_f32(sum_squares / samples, &band_rms);
+        }
+        sum_squares = 0.0f;
+        samples = 0;
+    }
+};
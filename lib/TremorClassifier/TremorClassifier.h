@@ -0,0 +1,145 @@
+#pragma once
+
+#include "arm_math.h"
+#include "SpectralEmbedding.h"
+
+// Feature vector layout, shared with tools/train_gnb.py
+#define FEATURE_PEAK_FREQ   0 // Dominant frequency (hz), DC excluded
+#define FEATURE_TREMOR_BAND 1 // Fraction of energy in the 3-6 hz rest tremor band
+#define FEATURE_LOW_BAND    2 // Fraction of energy below 2 hz (voluntary motion)
+#define FEATURE_LOG_ENERGY  3 // log10 of total spectral energy
+#define FEATURE_CEPSTRUM    4 // Cepstral coefficients 1.. of the window embedding (c0 duplicates the log energy)
+#define TREMOR_CEPSTRAL_FEATURES (EMBEDDING_SIZE - 1)
+#define TREMOR_NUM_FEATURES (FEATURE_CEPSTRUM + TREMOR_CEPSTRAL_FEATURES)
+
+#define TREMOR_BAND_LOW_HZ  3.0f
+#define TREMOR_BAND_HIGH_HZ 6.0f
+#define LOW_BAND_HIGH_HZ    2.0f
+
+#define TREMOR_NUM_CLASSES 3
+enum TremorClass {
+    CLASS_QUIET = 0,
+    CLASS_VOLUNTARY = 1,
+    CLASS_REST_TREMOR = 2
+};
+
+// Model tables generated by tools/train_gnb.py (see src/gnb_model.c)
+extern "C" {
+    extern const float32_t gnb_theta[TREMOR_NUM_CLASSES * TREMOR_NUM_FEATURES];
+    extern const float32_t gnb_sigma[TREMOR_NUM_CLASSES * TREMOR_NUM_FEATURES];
+    extern const float32_t gnb_priors[TREMOR_NUM_CLASSES];
+    extern const float32_t gnb_epsilon;
+}
+
+/**
+ * Computes the per-window feature vector from a magnitude spectrum and the window's cepstral embedding.
+ *
+ * @param magnitude Magnitude spectrum, at least num_bins long (only the first half is used).
+ * @param num_bins Number of FFT bins (FFT size).
+ * @param bin_hz Width of one bin in hz.
+ * @param cepstrum EMBEDDING_SIZE coefficients from SpectralEmbedding::compute() of the same window.
+ * @param features Output array of TREMOR_NUM_FEATURES floats.
+ *
+ * @returns None
+ */
+inline void extractTremorFeatures(const float32_t *magnitude, uint32_t num_bins, float32_t bin_hz, const float32_t *cepstrum,
+                                  float32_t *features) {
+    arm_copy_f32(cepstrum + 1, features + FEATURE_CEPSTRUM, TREMOR_CEPSTRAL_FEATURES);
+
+    float32_t total = 0.0f;
+    float32_t tremor_band = 0.0f;
+    float32_t low_band = 0.0f;
+    float32_t peak = 0.0f;
+    uint32_t peak_index = 1;
+
+    // Skip DC, only the positive half of the spectrum carries information for real input
+    for (uint32_t i = 1; i < num_bins / 2; i++) {
+        float32_t freq = i * bin_hz;
+        float32_t energy = magnitude[i] * magnitude[i];
+        total += energy;
+        if (freq >= TREMOR_BAND_LOW_HZ && freq <= TREMOR_BAND_HIGH_HZ)
+            tremor_band += energy;
+        else if (freq < LOW_BAND_HIGH_HZ)
+            low_band += energy;
+        if (magnitude[i] > peak) {
+            peak = magnitude[i];
+            peak_index = i;
+        }
+    }
+
+    if (total <= 0.0f) {
+        features[FEATURE_PEAK_FREQ] = 0.0f;
+        features[FEATURE_TREMOR_BAND] = 0.0f;
+        features[FEATURE_LOW_BAND] = 0.0f;
+        features[FEATURE_LOG_ENERGY] = -6.0f;
+        return;
+    }
+    features[FEATURE_PEAK_FREQ] = peak_index * bin_hz;
+    features[FEATURE_TREMOR_BAND] = tremor_band / total;
+    features[FEATURE_LOW_BAND] = low_band / total;
+    features[FEATURE_LOG_ENERGY] = log10f(total);
+}
+
+/**
+ * @brief Three class Gaussian naive Bayes classifier (quiet / voluntary motion / rest tremor)
+ *  built on arm_gaussian_naive_bayes_predict_f32 with statically trained tables.
+ *
+ */
+class TremorClassifier {
+private:
+    arm_gaussian_naive_bayes_instance_f32 model;
+    float32_t buffer[TREMOR_NUM_CLASSES];
+
+public:
+    // Posterior probability of each class for the last window
+    float32_t probabilities[TREMOR_NUM_CLASSES] = {0};
+
+    /** Default Constructor
+     * Binds the classifier to the generated model tables.
+     *
+     * @returns None
+     */
+    TremorClassifier() {
+        model.vectorDimension = TREMOR_NUM_FEATURES;
+        model.numberOfClasses = TREMOR_NUM_CLASSES;
+        model.theta = gnb_theta;
+        model.sigma = gnb_sigma;
+        model.classPriors = gnb_priors;
+        model.epsilon = gnb_epsilon;
+    }
+
+    /**
+     * Classifies a feature vector and stores the posterior probabilities.
+     *
+     * @param features Array of TREMOR_NUM_FEATURES floats from extractTremorFeatures().
+     *
+     * @returns TremorClass most likely class
+     */
+    TremorClass classify(const float32_t *features) {
+        // CMSIS returns joint log likelihoods, normalize them into probabilities
+        uint32_t index = arm_gaussian_naive_bayes_predict_f32(&model, features, probabilities, buffer);
+
+        float32_t max_log = probabilities[index];
+        float32_t sum = 0.0f;
+        for (int i = 0; i < TREMOR_NUM_CLASSES; i++) {
+            probabilities[i] = expf(probabilities[i] - max_log);
+            sum += probabilities[i];
+        }
+        for (int i = 0; i < TREMOR_NUM_CLASSES; i++) {
+            probabilities[i] /= sum;
+        }
+        return static_cast<TremorClass>(index);
+    }
+
+    /**
+     * Confidence of the most recent decision.
+     *
+     * @returns float posterior probability of the winning class in [0, 1]
+     */
+    float32_t confidence() {
+        float32_t max_value;
+        uint32_t max_index;
+        arm_max_f32(probabilities, TREMOR_NUM_CLASSES, &max_value, &max_index);
+        return max_value;
+    }
+};
@@ -0,0 +1,140 @@
+// DPSS tapers for Multitaper (N = 256, NW = 2.5, K = 4), generated by tools/gen_dpss.py
+
+#include "arm_math.h"
+
+const float32_t dpss_eigenvalues[] = {0.99999719f, 0.99984322f, 0.99621863f, 0.95214349f};
+
+const float32_t dpss_tapers[] = {
+    // taper 0, lambda 0.99999719
+    4.5350692e-04f, 5.4974179e-04f, 6.5557178e-04f, 7.7149672e-04f, 8.9802307e-04f, 1.0356632e-03f, 1.1849346e-03f, 1.3463589e-03f,
+    1.5204611e-03f, 1.7077689e-03f, 1.9088112e-03f, 2.1241177e-03f, 2.3542174e-03f, 2.5996382e-03f, 2.8609051e-03f, 3.1385398e-03f,
+    3.4330592e-03f, 3.7449742e-03f, 4.0747892e-03f, 4.4230002e-03f, 4.7900940e-03f, 5.1765471e-03f, 5.5828243e-03f, 6.0093777e-03f,
+    6.4566453e-03f, 6.9250500e-03f, 7.4149984e-03f, 7.9268796e-03f, 8.4610637e-03f, 9.0179011e-03f, 9.5977213e-03f, 1.0200831e-02f,
+    1.0827515e-02f, 1.1478031e-02f, 1.2152615e-02f, 1.2851472e-02f, 1.3574783e-02f, 1.4322699e-02f, 1.5095341e-02f, 1.5892800e-02f,
+    1.6715136e-02f, 1.7562375e-02f, 1.8434513e-02f, 1.9331509e-02f, 2.0253289e-02f, 2.1199744e-02f, 2.2170729e-02f, 2.3166062e-02f,
+    2.4185525e-02f, 2.5228862e-02f, 2.6295780e-02f, 2.7385947e-02f, 2.8498994e-02f, 2.9634512e-02f, 3.0792056e-02f, 3.1971140e-02f,
+    3.3171241e-02f, 3.4391795e-02f, 3.5632202e-02f, 3.6891825e-02f, 3.8169985e-02f, 3.9465970e-02f, 4.0779029e-02f, 4.2108373e-02f,
+    4.3453180e-02f, 4.4812591e-02f, 4.6185714e-02f, 4.7571621e-02f, 4.8969353e-02f, 5.0377919e-02f, 5.1796297e-02f, 5.3223435e-02f,
+    5.4658252e-02f, 5.6099640e-02f, 5.7546465e-02f, 5.8997569e-02f, 6.0451768e-02f, 6.1907859e-02f, 6.3364617e-02f, 6.4820798e-02f,
+    6.6275142e-02f, 6.7726371e-02f, 6.9173194e-02f, 7.0614310e-02f, 7.2048405e-02f, 7.3474156e-02f, 7.4890236e-02f, 7.6295309e-02f,
+    7.7688041e-02f, 7.9067091e-02f, 8.0431125e-02f, 8.1778806e-02f, 8.3108807e-02f, 8.4419802e-02f, 8.5710480e-02f, 8.6979534e-02f,
+    8.8225676e-02f, 8.9447628e-02f, 9.0644130e-02f, 9.1813941e-02f, 9.2955839e-02f, 9.4068626e-02f, 9.5151126e-02f, 9.6202192e-02f,
+    9.7220702e-02f, 9.8205565e-02f, 9.9155720e-02f, 1.0007014e-01f, 1.0094783e-01f, 1.0178784e-01f, 1.0258925e-01f, 1.0335117e-01f,
+    1.0407278e-01f, 1.0475327e-01f, 1.0539188e-01f, 1.0598792e-01f, 1.0654071e-01f, 1.0704964e-01f, 1.0751415e-01f, 1.0793370e-01f,
+    1.0830784e-01f, 1.0863613e-01f, 1.0891822e-01f, 1.0915378e-01f, 1.0934255e-01f, 1.0948431e-01f, 1.0957891e-01f, 1.0962623e-01f,
+    1.0962623e-01f, 1.0957891e-01f, 1.0948431e-01f, 1.0934255e-01f, 1.0915378e-01f, 1.0891822e-01f, 1.0863613e-01f, 1.0830784e-01f,
+    1.0793370e-01f, 1.0751415e-01f, 1.0704964e-01f, 1.0654071e-01f, 1.0598792e-01f, 1.0539188e-01f, 1.0475327e-01f, 1.0407278e-01f,
+    1.0335117e-01f, 1.0258925e-01f, 1.0178784e-01f, 1.0094783e-01f, 1.0007014e-01f, 9.9155720e-02f, 9.8205565e-02f, 9.7220702e-02f,
+    9.6202192e-02f, 9.5151126e-02f, 9.4068626e-02f, 9.2955839e-02f, 9.1813941e-02f, 9.0644130e-02f, 8.9447628e-02f, 8.8225676e-02f,
+    8.6979534e-02f, 8.5710480e-02f, 8.4419802e-02f, 8.3108807e-02f, 8.1778806e-02f, 8.0431125e-02f, 7.9067091e-02f, 7.7688041e-02f,
+    7.6295309e-02f, 7.4890236e-02f, 7.3474156e-02f, 7.2048405e-02f, 7.0614310e-02f, 6.9173194e-02f, 6.7726371e-02f, 6.6275142e-02f,
+    6.4820798e-02f, 6.3364617e-02f, 6.1907859e-02f, 6.0451768e-02f, 5.8997569e-02f, 5.7546465e-02f, 5.6099640e-02f, 5.4658252e-02f,
+    5.3223435e-02f, 5.1796297e-02f, 5.0377919e-02f, 4.8969353e-02f, 4.7571621e-02f, 4.6185714e-02f, 4.4812591e-02f, 4.3453180e-02f,
+    4.2108373e-02f, 4.0779029e-02f, 3.9465970e-02f, 3.8169985e-02f, 3.6891825e-02f, 3.5632202e-02f, 3.4391795e-02f, 3.3171241e-02f,
+    3.1971140e-02f, 3.0792056e-02f, 2.9634512e-02f, 2.8498994e-02f, 2.7385947e-02f, 2.6295780e-02f, 2.5228862e-02f, 2.4185525e-02f,
+    2.3166062e-02f, 2.2170729e-02f, 2.1199744e-02f, 2.0253289e-02f, 1.9331509e-02f, 1.8434513e-02f, 1.7562375e-02f, 1.6715136e-02f,
+    1.5892800e-02f, 1.5095341e-02f, 1.4322699e-02f, 1.3574783e-02f, 1.2851472e-02f, 1.2152615e-02f, 1.1478031e-02f, 1.0827515e-02f,
+    1.0200831e-02f, 9.5977213e-03f, 9.0179011e-03f, 8.4610637e-03f, 7.9268796e-03f, 7.4149984e-03f, 6.9250500e-03f, 6.4566453e-03f,
+    6.0093777e-03f, 5.5828243e-03f, 5.1765471e-03f, 4.7900940e-03f, 4.4230002e-03f, 4.0747892e-03f, 3.7449742e-03f, 3.4330592e-03f,
+    3.1385398e-03f, 2.8609051e-03f, 2.5996382e-03f, 2.3542174e-03f, 2.1241177e-03f, 1.9088112e-03f, 1.7077689e-03f, 1.5204611e-03f,
+    1.3463589e-03f, 1.1849346e-03f, 1.0356632e-03f, 8.9802307e-04f, 7.7149672e-04f, 6.5557178e-04f, 5.4974179e-04f, 4.5350692e-04f,
+    // taper 1, lambda 0.99984322
+    3.1638077e-03f, 3.6543808e-03f, 4.1781914e-03f, 4.7359558e-03f, 5.3283426e-03f, 5.9559698e-03f, 6.6194022e-03f, 7.3191478e-03f,
+    8.0556554e-03f, 8.8293117e-03f, 9.6404385e-03f, 1.0489290e-02f, 1.1376051e-02f, 1.2300834e-02f, 1.3263676e-02f, 1.4264538e-02f,
+    1.5303302e-02f, 1.6379769e-02f, 1.7493659e-02f, 1.8644606e-02f, 1.9832161e-02f, 2.1055786e-02f, 2.2314857e-02f, 2.3608662e-02f,
+    2.4936398e-02f, 2.6297175e-02f, 2.7690009e-02f, 2.9113830e-02f, 3.0567477e-02f, 3.2049697e-02f, 3.3559151e-02f, 3.5094410e-02f,
+    3.6653958e-02f, 3.8236193e-02f, 3.9839427e-02f, 4.1461891e-02f, 4.3101731e-02f, 4.4757018e-02f, 4.6425741e-02f, 4.8105818e-02f,
+    4.9795094e-02f, 5.1491343e-02f, 5.3192274e-02f, 5.4895534e-02f, 5.6598710e-02f, 5.8299330e-02f, 5.9994875e-02f, 6.1682774e-02f,
+    6.3360414e-02f, 6.5025142e-02f, 6.6674268e-02f, 6.8305075e-02f, 6.9914816e-02f, 7.1500726e-02f, 7.3060022e-02f, 7.4589912e-02f,
+    7.6087596e-02f, 7.7550275e-02f, 7.8975153e-02f, 8.0359447e-02f, 8.1700386e-02f, 8.2995223e-02f, 8.4241237e-02f, 8.5435737e-02f,
+    8.6576072e-02f, 8.7659632e-02f, 8.8683858e-02f, 8.9646243e-02f, 9.0544341e-02f, 9.1375769e-02f, 9.2138215e-02f, 9.2829442e-02f,
+    9.3447294e-02f, 9.3989699e-02f, 9.4454677e-02f, 9.4840341e-02f, 9.5144903e-02f, 9.5366682e-02f, 9.5504102e-02f, 9.5555700e-02f,
+    9.5520130e-02f, 9.5396164e-02f, 9.5182699e-02f, 9.4878757e-02f, 9.4483490e-02f, 9.3996183e-02f, 9.3416255e-02f, 9.2743261e-02f,
+    9.1976899e-02f, 9.1117004e-02f, 9.0163554e-02f, 8.9116673e-02f, 8.7976628e-02f, 8.6743831e-02f, 8.5418841e-02f, 8.4002362e-02f,
+    8.2495243e-02f, 8.0898480e-02f, 7.9213213e-02f, 7.7440723e-02f, 7.5582436e-02f, 7.3639918e-02f, 7.1614871e-02f, 6.9509136e-02f,
+    6.7324687e-02f, 6.5063628e-02f, 6.2728192e-02f, 6.0320737e-02f, 5.7843742e-02f, 5.5299803e-02f, 5.2691629e-02f, 5.0022038e-02f,
+    4.7293955e-02f, 4.4510401e-02f, 4.1674494e-02f, 3.8789442e-02f, 3.5858536e-02f, 3.2885147e-02f, 2.9872718e-02f, 2.6824762e-02f,
+    2.3744850e-02f, 2.0636610e-02f, 1.7503719e-02f, 1.4349897e-02f, 1.1178899e-02f, 7.9945122e-03f, 4.8005443e-03f, 1.6008212e-03f,
+    -1.6008212e-03f, -4.8005443e-03f, -7.9945122e-03f, -1.1178899e-02f, -1.4349897e-02f, -1.7503719e-02f, -2.0636610e-02f, -2.3744850e-02f,
+    -2.6824762e-02f, -2.9872718e-02f, -3.2885147e-02f, -3.5858536e-02f, -3.8789442e-02f, -4.1674494e-02f, -4.4510401e-02f, -4.7293955e-02f,
+    -5.0022038e-02f, -5.2691629e-02f, -5.5299803e-02f, -5.7843742e-02f, -6.0320737e-02f, -6.2728192e-02f, -6.5063628e-02f, -6.7324687e-02f,
+    -6.9509136e-02f, -7.1614871e-02f, -7.3639918e-02f, -7.5582436e-02f, -7.7440723e-02f, -7.9213213e-02f, -8.0898480e-02f, -8.2495243e-02f,
+    -8.4002362e-02f, -8.5418841e-02f, -8.6743831e-02f, -8.7976628e-02f, -8.9116673e-02f, -9.0163554e-02f, -9.1117004e-02f, -9.1976899e-02f,
+    -9.2743261e-02f, -9.3416255e-02f, -9.3996183e-02f, -9.4483490e-02f, -9.4878757e-02f, -9.5182699e-02f, -9.5396164e-02f, -9.5520130e-02f,
+    -9.5555700e-02f, -9.5504102e-02f, -9.5366682e-02f, -9.5144903e-02f, -9.4840341e-02f, -9.4454677e-02f, -9.3989699e-02f, -9.3447294e-02f,
+    -9.2829442e-02f, -9.2138215e-02f, -9.1375769e-02f, -9.0544341e-02f, -8.9646243e-02f, -8.8683858e-02f, -8.7659632e-02f, -8.6576072e-02f,
+    -8.5435737e-02f, -8.4241237e-02f, -8.2995223e-02f, -8.1700386e-02f, -8.0359447e-02f, -7.8975153e-02f, -7.7550275e-02f, -7.6087596e-02f,
+    -7.4589912e-02f, -7.3060022e-02f, -7.1500726e-02f, -6.9914816e-02f, -6.8305075e-02f, -6.6674268e-02f, -6.5025142e-02f, -6.3360414e-02f,
+    -6.1682774e-02f, -5.9994875e-02f, -5.8299330e-02f, -5.6598710e-02f, -5.4895534e-02f, -5.3192274e-02f, -5.1491343e-02f, -4.9795094e-02f,
+    -4.8105818e-02f, -4.6425741e-02f, -4.4757018e-02f, -4.3101731e-02f, -4.1461891e-02f, -3.9839427e-02f, -3.8236193e-02f, -3.6653958e-02f,
+    -3.5094410e-02f, -3.3559151e-02f, -3.2049697e-02f, -3.0567477e-02f, -2.9113830e-02f, -2.7690009e-02f, -2.6297175e-02f, -2.4936398e-02f,
+    -2.3608662e-02f, -2.2314857e-02f, -2.1055786e-02f, -1.9832161e-02f, -1.8644606e-02f, -1.7493659e-02f, -1.6379769e-02f, -1.5303302e-02f,
+    -1.4264538e-02f, -1.3263676e-02f, -1.2300834e-02f, -1.1376051e-02f, -1.0489290e-02f, -9.6404385e-03f, -8.8293117e-03f, -8.0556554e-03f,
+    -7.3191478e-03f, -6.6194022e-03f, -5.9559698e-03f, -5.3283426e-03f, -4.7359558e-03f, -4.1781914e-03f, -3.6543808e-03f, -3.1638077e-03f,
+    // taper 2, lambda 0.99621863
+    1.4360824e-02f, 1.5838290e-02f, 1.7368068e-02f, 1.8948698e-02f, 2.0578557e-02f, 2.2255855e-02f, 2.3978642e-02f, 2.5744806e-02f,
+    2.7552073e-02f, 2.9398016e-02f, 3.1280053e-02f, 3.3195451e-02f, 3.5141330e-02f, 3.7114669e-02f, 3.9112310e-02f, 4.1130961e-02f,
+    4.3167206e-02f, 4.5217508e-02f, 4.7278214e-02f, 4.9345567e-02f, 5.1415709e-02f, 5.3484690e-02f, 5.5548476e-02f, 5.7602959e-02f,
+    5.9643963e-02f, 6.1667255e-02f, 6.3668551e-02f, 6.5643532e-02f, 6.7587846e-02f, 6.9497126e-02f, 7.1366992e-02f, 7.3193068e-02f,
+    7.4970989e-02f, 7.6696414e-02f, 7.8365033e-02f, 7.9972581e-02f, 8.1514849e-02f, 8.2987693e-02f, 8.4387044e-02f, 8.5708924e-02f,
+    8.6949449e-02f, 8.8104845e-02f, 8.9171458e-02f, 9.0145762e-02f, 9.1024370e-02f, 9.1804044e-02f, 9.2481707e-02f, 9.3054446e-02f,
+    9.3519528e-02f, 9.3874404e-02f, 9.4116720e-02f, 9.4244323e-02f, 9.4255270e-02f, 9.4147835e-02f, 9.3920512e-02f, 9.3572029e-02f,
+    9.3101345e-02f, 9.2507660e-02f, 9.1790421e-02f, 9.0949321e-02f, 8.9984307e-02f, 8.8895580e-02f, 8.7683599e-02f, 8.6349084e-02f,
+    8.4893013e-02f, 8.3316626e-02f, 8.1621426e-02f, 7.9809173e-02f, 7.7881888e-02f, 7.5841848e-02f, 7.3691585e-02f, 7.1433882e-02f,
+    6.9071769e-02f, 6.6608519e-02f, 6.4047642e-02f, 6.1392881e-02f, 5.8648205e-02f, 5.5817799e-02f, 5.2906063e-02f, 4.9917599e-02f,
+    4.6857202e-02f, 4.3729856e-02f, 4.0540719e-02f, 3.7295115e-02f, 3.3998527e-02f, 3.0656578e-02f, 2.7275028e-02f, 2.3859758e-02f,
+    2.0416757e-02f, 1.6952114e-02f, 1.3472000e-02f, 9.9826602e-03f, 6.4903964e-03f, 3.0015561e-03f, -4.7748172e-04f, -3.9403203e-03f,
+    -7.3805591e-03f, -1.0791807e-02f, -1.4167698e-02f, -1.7501902e-02f, -2.0788142e-02f, -2.4020207e-02f, -2.7191964e-02f, -3.0297373e-02f,
+    -3.3330501e-02f, -3.6285536e-02f, -3.9156796e-02f, -4.1938746e-02f, -4.4626008e-02f, -4.7213376e-02f, -4.9695823e-02f, -5.2068517e-02f,
+    -5.4326830e-02f, -5.6466348e-02f, -5.8482882e-02f, -6.0372477e-02f, -6.2131423e-02f, -6.3756259e-02f, -6.5243786e-02f, -6.6591070e-02f,
+    -6.7795452e-02f, -6.8854553e-02f, -6.9766280e-02f, -7.0528827e-02f, -7.1140686e-02f, -7.1600644e-02f, -7.1907790e-02f, -7.2061515e-02f,
+    -7.2061515e-02f, -7.1907790e-02f, -7.1600644e-02f, -7.1140686e-02f, -7.0528827e-02f, -6.9766280e-02f, -6.8854553e-02f, -6.7795452e-02f,
+    -6.6591070e-02f, -6.5243786e-02f, -6.3756259e-02f, -6.2131423e-02f, -6.0372477e-02f, -5.8482882e-02f, -5.6466348e-02f, -5.4326830e-02f,
+    -5.2068517e-02f, -4.9695823e-02f, -4.7213376e-02f, -4.4626008e-02f, -4.1938746e-02f, -3.9156796e-02f, -3.6285536e-02f, -3.3330501e-02f,
+    -3.0297373e-02f, -2.7191964e-02f, -2.4020207e-02f, -2.0788142e-02f, -1.7501902e-02f, -1.4167698e-02f, -1.0791807e-02f, -7.3805591e-03f,
+    -3.9403203e-03f, -4.7748172e-04f, 3.0015561e-03f, 6.4903964e-03f, 9.9826602e-03f, 1.3472000e-02f, 1.6952114e-02f, 2.0416757e-02f,
+    2.3859758e-02f, 2.7275028e-02f, 3.0656578e-02f, 3.3998527e-02f, 3.7295115e-02f, 4.0540719e-02f, 4.3729856e-02f, 4.6857202e-02f,
+    4.9917599e-02f, 5.2906063e-02f, 5.5817799e-02f, 5.8648205e-02f, 6.1392881e-02f, 6.4047642e-02f, 6.6608519e-02f, 6.9071769e-02f,
+    7.1433882e-02f, 7.3691585e-02f, 7.5841848e-02f, 7.7881888e-02f, 7.9809173e-02f, 8.1621426e-02f, 8.3316626e-02f, 8.4893013e-02f,
+    8.6349084e-02f, 8.7683599e-02f, 8.8895580e-02f, 8.9984307e-02f, 9.0949321e-02f, 9.1790421e-02f, 9.2507660e-02f, 9.3101345e-02f,
+    9.3572029e-02f, 9.3920512e-02f, 9.4147835e-02f, 9.4255270e-02f, 9.4244323e-02f, 9.4116720e-02f, 9.3874404e-02f, 9.3519528e-02f,
+    9.3054446e-02f, 9.2481707e-02f, 9.1804044e-02f, 9.1024370e-02f, 9.0145762e-02f, 8.9171458e-02f, 8.8104845e-02f, 8.6949449e-02f,
+    8.5708924e-02f, 8.4387044e-02f, 8.2987693e-02f, 8.1514849e-02f, 7.9972581e-02f, 7.8365033e-02f, 7.6696414e-02f, 7.4970989e-02f,
+    7.3193068e-02f, 7.1366992e-02f, 6.9497126e-02f, 6.7587846e-02f, 6.5643532e-02f, 6.3668551e-02f, 6.1667255e-02f, 5.9643963e-02f,
+    5.7602959e-02f, 5.5548476e-02f, 5.3484690e-02f, 5.1415709e-02f, 4.9345567e-02f, 4.7278214e-02f, 4.5217508e-02f, 4.3167206e-02f,
+    4.1130961e-02f, 3.9112310e-02f, 3.7114669e-02f, 3.5141330e-02f, 3.3195451e-02f, 3.1280053e-02f, 2.9398016e-02f, 2.7552073e-02f,
+    2.5744806e-02f, 2.3978642e-02f, 2.2255855e-02f, 2.0578557e-02f, 1.8948698e-02f, 1.7368068e-02f, 1.5838290e-02f, 1.4360824e-02f,
+    // taper 3, lambda 0.95214349
+    4.6295341e-02f, 4.8930129e-02f, 5.1558479e-02f, 5.4174110e-02f, 5.6770666e-02f, 5.9341740e-02f, 6.1880888e-02f, 6.4381645e-02f,
+    6.6837546e-02f, 6.9242141e-02f, 7.1589016e-02f, 7.3871807e-02f, 7.6084222e-02f, 7.8220057e-02f, 8.0273214e-02f, 8.2237720e-02f,
+    8.4107745e-02f, 8.5877617e-02f, 8.7541843e-02f, 8.9095123e-02f, 9.0532367e-02f, 9.1848713e-02f, 9.3039541e-02f, 9.4100488e-02f,
+    9.5027464e-02f, 9.5816663e-02f, 9.6464582e-02f, 9.6968025e-02f, 9.7324123e-02f, 9.7530340e-02f, 9.7584485e-02f, 9.7484719e-02f,
+    9.7229567e-02f, 9.6817924e-02f, 9.6249059e-02f, 9.5522623e-02f, 9.4638654e-02f, 9.3597578e-02f, 9.2400213e-02f, 9.1047768e-02f,
+    8.9541847e-02f, 8.7884446e-02f, 8.6077950e-02f, 8.4125130e-02f, 8.2029143e-02f, 7.9793520e-02f, 7.7422165e-02f, 7.4919345e-02f,
+    7.2289683e-02f, 6.9538146e-02f, 6.6670038e-02f, 6.3690986e-02f, 6.0606927e-02f, 5.7424098e-02f, 5.4149017e-02f, 5.0788472e-02f,
+    4.7349501e-02f, 4.3839380e-02f, 4.0265600e-02f, 3.6635854e-02f, 3.2958013e-02f, 2.9240112e-02f, 2.5490323e-02f, 2.1716943e-02f,
+    1.7928363e-02f, 1.4133057e-02f, 1.0339551e-02f, 6.5564076e-03f, 2.7922008e-03f, -9.4450648e-04f, -4.6451837e-03f, -8.3013558e-03f,
+    -1.1904626e-02f, -1.5446696e-02f, -1.8919392e-02f, -2.2314684e-02f, -2.5624705e-02f, -2.8841780e-02f, -3.1958437e-02f, -3.4967435e-02f,
+    -3.7861781e-02f, -4.0634750e-02f, -4.3279901e-02f, -4.5791098e-02f, -4.8162527e-02f, -5.0388710e-02f, -5.2464522e-02f, -5.4385207e-02f,
+    -5.6146388e-02f, -5.7744084e-02f, -5.9174716e-02f, -6.0435125e-02f, -6.1522575e-02f, -6.2434764e-02f, -6.3169831e-02f, -6.3726363e-02f,
+    -6.4103398e-02f, -6.4300429e-02f, -6.4317408e-02f, -6.4154746e-02f, -6.3813312e-02f, -6.3294433e-02f, -6.2599893e-02f, -6.1731926e-02f,
+    -6.0693212e-02f, -5.9486871e-02f, -5.8116459e-02f, -5.6585952e-02f, -5.4899744e-02f, -5.3062631e-02f, -5.1079800e-02f, -4.8956818e-02f,
+    -4.6699617e-02f, -4.4314476e-02f, -4.1808010e-02f, -3.9187149e-02f, -3.6459122e-02f, -3.3631437e-02f, -3.0711863e-02f, -2.7708410e-02f,
+    -2.4629306e-02f, -2.1482979e-02f, -1.8278030e-02f, -1.5023216e-02f, -1.1727425e-02f, -8.3996496e-03f, -5.0489688e-03f, -1.6845207e-03f,
+    1.6845207e-03f, 5.0489688e-03f, 8.3996496e-03f, 1.1727425e-02f, 1.5023216e-02f, 1.8278030e-02f, 2.1482979e-02f, 2.4629306e-02f,
+    2.7708410e-02f, 3.0711863e-02f, 3.3631437e-02f, 3.6459122e-02f, 3.9187149e-02f, 4.1808010e-02f, 4.4314476e-02f, 4.6699617e-02f,
+    4.8956818e-02f, 5.1079800e-02f, 5.3062631e-02f, 5.4899744e-02f, 5.6585952e-02f, 5.8116459e-02f, 5.9486871e-02f, 6.0693212e-02f,
+    6.1731926e-02f, 6.2599893e-02f, 6.3294433e-02f, 6.3813312e-02f, 6.4154746e-02f, 6.4317408e-02f, 6.4300429e-02f, 6.4103398e-02f,
+    6.3726363e-02f, 6.3169831e-02f, 6.2434764e-02f, 6.1522575e-02f, 6.0435125e-02f, 5.9174716e-02f, 5.7744084e-02f, 5.6146388e-02f,
+    5.4385207e-02f, 5.2464522e-02f, 5.0388710e-02f, 4.8162527e-02f, 4.5791098e-02f, 4.3279901e-02f, 4.0634750e-02f, 3.7861781e-02f,
+    3.4967435e-02f, 3.1958437e-02f, 2.8841780e-02f, 2.5624705e-02f, 2.2314684e-02f, 1.8919392e-02f, 1.5446696e-02f, 1.1904626e-02f,
+    8.3013558e-03f, 4.6451837e-03f, 9.4450648e-04f, -2.7922008e-03f, -6.5564076e-03f, -1.0339551e-02f, -1.4133057e-02f, -1.7928363e-02f,
+    -2.1716943e-02f, -2.5490323e-02f, -2.9240112e-02f, -3.2958013e-02f, -3.6635854e-02f, -4.0265600e-02f, -4.3839380e-02f, -4.7349501e-02f,
+    -5.0788472e-02f, -5.4149017e-02f, -5.7424098e-02f, -6.0606927e-02f, -6.3690986e-02f, -6.6670038e-02f, -6.9538146e-02f, -7.2289683e-02f,
+    -7.4919345e-02f, -7.7422165e-02f, -7.9793520e-02f, -8.2029143e-02f, -8.4125130e-02f, -8.6077950e-02f, -8.7884446e-02f, -8.9541847e-02f,
+    -9.1047768e-02f, -9.2400213e-02f, -9.3597578e-02f, -9.4638654e-02f, -9.5522623e-02f, -9.6249059e-02f, -9.6817924e-02f, -9.7229567e-02f,
+    -9.7484719e-02f, -9.7584485e-02f, -9.7530340e-02f, -9.7324123e-02f, -9.6968025e-02f, -9.6464582e-02f, -9.5816663e-02f, -9.5027464e-02f,
+    -9.4100488e-02f, -9.3039541e-02f, -9.1848713e-02f, -9.0532367e-02f, -8.9095123e-02f, -8.7541843e-02f, -8.5877617e-02f, -8.4107745e-02f,
+    -8.2237720e-02f, -8.0273214e-02f, -7.8220057e-02f, -7.6084222e-02f, -7.3871807e-02f, -7.1589016e-02f, -6.9242141e-02f, -6.6837546e-02f,
+    -6.4381645e-02f, -6.1880888e-02f, -5.9341740e-02f, -5.6770666e-02f, -5.4174110e-02f, -5.1558479e-02f, -4.8930129e-02f, -4.6295341e-02f,
+};
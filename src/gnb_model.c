@@ -0,0 +1,32 @@
+// Gaussian naive Bayes tables for TremorClassifier: hand-set seed in the layout tools/train_gnb.py writes
+// Classes: quiet, voluntary, rest tremor. Features: peak hz, tremor band, low band, log energy, c1 .. c11
+//
+// Seed model: hand-set from the expected signal levels (noise floor ~0.01 rad/s at rest,
+// ~1 rad/s slow voluntary motion, ~0.5 rad/s 3-6 hz rest tremor) until labelled wear
+// captures are available. The cepstral features get the same mean and variance in every
+// class, so they add the same log likelihood to each class and leave the seed decisions to
+// the spectrum features until trained. Regenerate with tools/train_gnb.py.
+
+#include "arm_math.h"
+
+const float32_t gnb_theta[] = {
+    5.000000f, 0.200000f, 0.300000f, 0.500000f,
+    0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f,
+    1.000000f, 0.100000f, 0.700000f, 4.000000f,
+    0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f,
+    4.500000f, 0.600000f, 0.100000f, 3.500000f,
+    0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f, 0.000000f,
+};
+
+const float32_t gnb_sigma[] = {
+    20.000000f, 0.010000f, 0.030000f, 0.500000f,
+    100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f,
+    0.500000f, 0.005000f, 0.020000f, 0.800000f,
+    100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f,
+    0.600000f, 0.020000f, 0.010000f, 0.800000f,
+    100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f, 100.000000f,
+};
+
+const float32_t gnb_priors[] = {0.400000f, 0.400000f, 0.200000f};
+
+const float32_t gnb_epsilon = 0.000100f;
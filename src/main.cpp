@@ -11,6 +11,30 @@
  * |-- GUI
  * |-- Gyroscope
  * |-- MovingAverage
+ * |-- TremorClassifier
+ * |-- SpectralEmbedding
+ * |-- TemplateMatcher
+ * |-- ChangeDetector
+ * |-- TremorAmplitude
+ * |-- HilbertEnvelope
+ * |-- TeagerKaiser
+ * |-- Wavelet
+ * |-- LombScargle
+ * |-- Resampler
+ * |-- SubspaceEstimator
+ * |-- PhaseVocoder
+ * |-- Multitaper
+ * |-- FundamentalEstimator
+ * |-- Coherence
+ * |-- RingBuffer
+ * |-- Scheduler
+ * |-- Coroutine
+ * |-- DeadlineMonitor
+ * |-- CpuLoad
+ * |-- RateConverter
+ * |-- ClockGovernor
+ * |-- ActivityDetector
+ * |-- CycleCounter
  * |-- cmsis-dsp
  * 
  * 
@@ -22,7 +46,16 @@
  *          | Freq
  *          | Info
  *  These may be started/exited by the user via touch. (Note that fft and gyro sampling
- *  currently block touch IO in this version! Threading to come in future)
+ *  block touch IO in the default bare-metal build! Other build profiles avoid that:
+ *      | pio run -e disco_f429zi_rtos: acquisition, DSP and UI threads, see RTOS PROFILE
+ *      | pio run -e disco_f429zi_events: bare-metal, interrupt driven sampling and a cooperative
+ *        event scheduler, see EVENT PROFILE
+ *      | pio run -e disco_f429zi_coroutines: the same written as C++20 coroutines, see COROUTINE PROFILE
+ *      | pio run -e disco_f429zi_lowpower: the bare-metal loop, sleeping between gyroscope FIFO watermark
+ *        interrupts instead of waking for every sample
+ *      | pio run -e disco_f429zi_governor: the bare-metal loop at half the core clock while sampling
+ *      | pio run -e disco_f429zi_adaptive: the low power loop, only sampling fast and analyzing windows
+ *        while tremor-band activity is detected)
  * 
  * Usage:
  *  To identify Parkinson's tremors, the user is meant to put on the hand medical brace and strap in the board.
@@ -47,6 +80,32 @@
 #include "Gyroscope.h"
 #include "MovingAverage.h"
 #include "GUI.h"
+#include "TremorClassifier.h"
+#include "SpectralEmbedding.h"
+#include "TemplateMatcher.h"
+#include "ChangeDetector.h"
+#include "TremorAmplitude.h"
+#include "HilbertEnvelope.h"
+#include "TeagerKaiser.h"
+#include "Wavelet.h"
+#include "LombScargle.h"
+#include "Resampler.h"
+#include "SubspaceEstimator.h"
+#include "PhaseVocoder.h"
+#include "Multitaper.h"
+#include "FundamentalEstimator.h"
+#include "Coherence.h"
+#include "RingBuffer.h"
+#include "Scheduler.h"
+#ifdef TREMOR_COROUTINES
+#include "Coroutine.h"
+#endif
+#include "CycleCounter.h"
+#include "DeadlineMonitor.h"
+#include "CpuLoad.h"
+#include "RateConverter.h"
+#include "ClockGovernor.h"
+#include "ActivityDetector.h"
 
 // CMSIS DSP Library
 #include "arm_math.h"
@@ -57,6 +116,11 @@
 *******************************/
 // Store velocity data
 std::array<float, 3> velocity_xyz; 
+// Timestamped sample, as queued between acquisition and processing
+struct GyroSample {
+    uint32_t timestamp_us;
+    std::array<float, 3> xyz;
+};
 
 // Create moving averages
 MovingAverage<float, 3> moving_avg_freq;
@@ -67,6 +131,42 @@ arm_cfft_instance_f32 fft;
 // 256 samples X 30ms intervals = 7.68 seconds of window
 #define FFT_SIZE 256
 #define SAMPLING_FREQ 30 // in ms. This gives us 33.3 samples / sec
+#define SAMPLE_RATE_HZ (1000.0f / SAMPLING_FREQ)
+// Tremor frequency source: the FFT peak, the closest DTW template, the Teager-Kaiser/DESA-2 tracker,
+// the wavelet packet band energies, the Lomb-Scargle peak over the measured sample times, ESPRIT,
+// the phase vocoder on short overlapping frames, or the harmonic product spectrum fundamental
+#define DETECTOR_FFT 0
+#define DETECTOR_DTW 1
+#define DETECTOR_TKEO 2
+#define DETECTOR_DWT 3
+#define DETECTOR_LOMB 4
+#define DETECTOR_ESPRIT 5
+#define DETECTOR_VOCODER 6
+#define DETECTOR_HPS 7
+#ifndef DETECTOR_MODE
+#define DETECTOR_MODE DETECTOR_FFT
+#endif
+// Spectrum used by fourierTransform(): the single periodogram or the adaptive multitaper PSD
+#define SPECTRUM_PERIODOGRAM 0
+#define SPECTRUM_MULTITAPER 1
+#ifndef SPECTRUM_MODE
+#define SPECTRUM_MODE SPECTRUM_PERIODOGRAM
+#endif
+// Runs every estimator next to the selected detector and logs their comparison every window
+// (pio run -e disco_f429zi_benchmark). Otherwise only the stages of DETECTOR_MODE run
+#ifndef ESTIMATOR_BENCHMARK
+#define ESTIMATOR_BENCHMARK 0
+#endif
+#define RUN_TKEO (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_TKEO)
+#define RUN_DWT (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_DWT)
+#define RUN_LOMB (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_LOMB)
+#define RUN_ESPRIT (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_ESPRIT)
+#define RUN_VOCODER (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_VOCODER)
+#define RUN_HPS (ESTIMATOR_BENCHMARK || DETECTOR_MODE == DETECTOR_HPS)
+// Per-sample cross-spectra of the three axes, a coherent window restarts the frequency average
+#ifndef AXIS_COHERENCE
+#define AXIS_COHERENCE 0
+#endif
 float32_t fft_input[FFT_SIZE * 2] = {0};
 float32_t fft_output[FFT_SIZE] = {0};
 uint32_t ifftFlag = 0;
@@ -74,6 +174,177 @@ uint32_t doBitReverse = 1;
 float fft_maxValue;
 uint32_t fft_maxIndex;
 
+// Naive Bayes classifier, benchmarked against the threshold logic
+TremorClassifier classifier;
+float32_t tremor_features[TREMOR_NUM_FEATURES];
+CycleCounter threshold_cycles;
+CycleCounter classifier_cycles;
+const char* CLASS_NAMES[TREMOR_NUM_CLASSES] = {"QUIET", "MOTION", "TREMOR"};
+
+// Compact cepstral embedding of each window (12 floats instead of 128 magnitude bins)
+SpectralEmbedding embedding(SAMPLE_RATE_HZ);
+
+// DTW matching against the template library, worst case cycles per decision are reported
+TemplateMatcher matcher(SAMPLE_RATE_HZ);
+CycleCounter matcher_cycles;
+
+// Skips classification, logging and drawing while the spectrum is unchanged
+ChangeDetector change_detector;
+
+// Rotation amplitude of the tremor, integrated sample by sample while the window fills
+TremorAmplitude amplitude(SAMPLE_RATE_HZ);
+
+// Instantaneous amplitude / frequency of the band-passed signal, summarized every hop. The hops of a
+// window are kept and printed with it, serial output would stall the sampling loop
+HilbertEnvelope hilbert(SAMPLE_RATE_HZ);
+HilbertStats window_hops[FFT_SIZE / HILBERT_HOP];
+uint32_t window_hop_count = 0;
+
+// Always-on energy operator frequency tracker, compared against the FFT every window
+TeagerKaiser tkeo(SAMPLE_RATE_HZ);
+CycleCounter tkeo_cycles;
+CycleCounter fft_cycles;
+
+// Multiresolution alternative to the fixed window FFT, transformed block by block while sampling
+Wavelet wavelet(SAMPLE_RATE_HZ);
+CycleCounter wavelet_cycles;
+
+// Sampling is software timed, so the raw samples are kept with their hardware timestamps (seconds
+// since the window started) for the Lomb-Scargle periodogram, which does not assume uniform spacing
+float32_t raw_samples[FFT_SIZE] = {0};
+float32_t sample_times[FFT_SIZE] = {0};
+LombScargle lomb;
+CycleCounter lomb_cycles;
+
+// The interleaved profiles sample without gaps. The bare-metal loops pause sampling while a window is
+// analyzed, so state streamed across windows would span the pause
+#if defined(TREMOR_RTOS) || defined(TREMOR_EVENTS) || defined(TREMOR_COROUTINES)
+#define CONTINUOUS_SAMPLING 1
+#else
+#define CONTINUOUS_SAMPLING 0
+#endif
+
+// Moves the raw samples onto the exact nominal grid before the uniform-rate stages and reports jitter
+Resampler resampler(SAMPLE_RATE_HZ);
+CycleCounter resample_cycles;
+
+// ESPRIT on the band-passed window, benchmarked on the most recent 32..256 samples
+#define SUBSPACE_BENCH_LENGTHS 4
+const uint32_t SUBSPACE_LENGTHS[SUBSPACE_BENCH_LENGTHS] = {32, 64, 128, FFT_SIZE};
+// Only the full window is estimated outside the estimator benchmark
+#define SUBSPACE_FIRST_LENGTH (ESTIMATOR_BENCHMARK ? 0 : SUBSPACE_BENCH_LENGTHS - 1)
+float subspace_frequency[SUBSPACE_BENCH_LENGTHS] = {0};
+float subspace_fraction[SUBSPACE_BENCH_LENGTHS] = {0};
+SubspaceEstimator subspace(SAMPLE_RATE_HZ);
+CycleCounter subspace_cycles[SUBSPACE_BENCH_LENGTHS];
+
+// ESPRIT and the phase vocoder assume uniform spacing, they get the resampled window band-passed
+// by a filter of their own instead of the per-sample band of the jittered stream
+float32_t band_samples[FFT_SIZE] = {0};
+TremorBandpass grid_bandpass(SAMPLE_RATE_HZ);
+
+// 64-point frames every 16 grid samples when a window closes, refined by the phase advance of the peak bin
+PhaseVocoder vocoder(SAMPLE_RATE_HZ);
+CycleCounter vocoder_cycles;
+
+// Multitaper PSD, benchmarked against the periodogram and Welch on the 9-16 hz background every window
+#define SPECTRUM_BENCH_LOW_HZ 9.0f
+#define SPECTRUM_BENCH_HIGH_HZ 16.0f
+Multitaper multitaper;
+float32_t periodogram_psd[MULTITAPER_BINS];
+float32_t welch_psd[WELCH_BINS];
+CycleCounter multitaper_cycles;
+CycleCounter periodogram_cycles;
+CycleCounter welch_cycles;
+
+// Fundamental of the magnitude spectrum, immune to the second harmonic outgrowing the tremor peak
+FundamentalEstimator fundamental(SAMPLE_RATE_HZ);
+CycleCounter fundamental_cycles;
+
+// Cross-spectra of the three axes, accumulated segment by segment while sampling
+Coherence coherence(SAMPLE_RATE_HZ);
+CycleCounter coherence_cycles;
+const char* PAIR_NAMES[COHERENCE_PAIRS] = {"xy", "xz", "yz"};
+
+// Cycle budgets of the pipeline stages, misses and worst lateness are printed every window
+#define STAGE_ACQUIRE 0   // interval between two gyroscope reads
+#define STAGE_TRANSFORM 1 // spectral estimators of a window, without their serial logging
+#define STAGE_CLASSIFY 2  // moving average, thresholds and naive Bayes
+#define STAGE_DRAW 3      // LCD update with a window result
+#define STAGE_SAMPLE 4    // per-sample streaming stages
+#ifdef TREMOR_LOW_POWER
+// One FIFO read per wakeup, due before the FIFO overflows
+#define FIFO_BUDGET_US(odr_hz) (GYRO_FIFO_DEPTH * 1000000 / (odr_hz))
+#define ACQUIRE_BUDGET_US FIFO_BUDGET_US(GYRO_FIFO_ODR_HZ)
+#else
+#define ACQUIRE_BUDGET_US (SAMPLING_FREQ * 1000 + 3000)
+#endif
+// The computation of a window fits in one sample period, so it holds back at most one queued sample
+#define TRANSFORM_BUDGET_US (SAMPLING_FREQ * 1000)
+#define CLASSIFY_BUDGET_US 2000
+#define DRAW_BUDGET_US 20000
+#define SAMPLE_BUDGET_US 1000
+// Shows the miss counters in the corner of the tremor and frequency screens
+#ifndef DEADLINE_OVERLAY
+#define DEADLINE_OVERLAY 0
+#endif
+DeadlineMonitor deadlines;
+
+// Utilization per CPU_LOAD_PERIOD_MS split by the stages above, printed and shown on the info screen
+#define LOAD_GAUGE_X 110
+#define LOAD_GAUGE_WIDTH 120
+CpuLoad cpu_load(deadlines);
+bool updateLoad(void);
+
+// Awake share and wakeups of the last window fill, to compare the acquisition modes
+mbed_stats_cpu_t acquisition_start;
+uint32_t acquisition_wakeups = 0;
+#ifdef TREMOR_LOW_POWER
+// FIFO level that wakes the MCU: ~4 wakeups/s at 95 Hz, 8 samples (84 ms) of margin before overrun
+// (~8 wakeups/s and 42 ms at the 190 Hz of an adaptive capture)
+#define FIFO_WATERMARK 24
+// Created in main(), keeps its SPI link open for good
+Gyroscope* fifo_gyro = nullptr;
+InterruptIn fifo_int(GYRO_INT2_PIN);
+volatile bool fifo_ready = false;
+std::array<float, 3> fifo_xyz[GYRO_FIFO_DEPTH];
+// FIFO samples onto the SAMPLING_FREQ grid the pipeline expects
+RateConverter rate_converter(SAMPLING_FREQ * 1000);
+#endif
+// False when a window fill was given up, the buffers then hold no new window to analyze
+bool window_filled = true;
+
+#ifdef ADAPTIVE_SAMPLING
+#ifndef TREMOR_LOW_POWER
+#error "ADAPTIVE_SAMPLING switches the data rate of the FIFO acquisition, build with TREMOR_LOW_POWER"
+#endif
+// Watch mode: 95 Hz with a nearly full FIFO per wakeup (~3 wakeups/s), only the activity detector runs.
+// Capture mode: 190 Hz and the full pipeline, until the activity has ended at the end of a window.
+// The analysis grid stays at SAMPLING_FREQ in both modes (every stage, template and model is built for
+// it); the faster rate brings the FIFO samples closer to each grid point, which cuts the interpolation
+// error of the rate converter about fourfold (3.4% -> 0.8% of the amplitude at 8 hz)
+#define WATCH_WATERMARK 30
+// Grid samples kept while watching (~1.9 s), they open the window of a capture so the onset is in it.
+// They are on the analysis grid already, so they need no resampling when the rate switches
+#define PRETRIGGER_SAMPLES 64
+ActivityDetector activity(SAMPLE_RATE_HZ);
+RingBuffer<GyroSample, PRETRIGGER_SAMPLES, RING_OVERWRITE_OLDEST> pretrigger;
+bool capturing = false;
+uint32_t pretrigger_used = 0;
+uint32_t mode_start_us = 0;
+uint64_t watch_us = 0;
+uint64_t capture_us = 0;
+#endif
+
+#ifdef CLOCK_GOVERNOR
+// The RTOS tick and the interleaved profiles have no sampling-only phase to slow down
+#if defined(TREMOR_RTOS) || defined(TREMOR_EVENTS) || defined(TREMOR_COROUTINES)
+#error "CLOCK_GOVERNOR follows the phases of the bare-metal loop"
+#endif
+// Core clock per phase of the loop: CLOCK_LOW while a window is collected, CLOCK_BOOST to analyze it
+ClockGovernor governor;
+#endif
+
 
 /* Create and initilialize GUI */
 GUI gui("TrmrGlv 1.0");
@@ -98,6 +369,320 @@ Region* TREMOR_BUTTON = new EllipseRegion(120, 100, 64, 32, LCD_COLOR_DARKGREEN,
 std::vector<Region*> TREMOR_UI = {
     new RectRegion(0, 40, 240, 280, LCD_COLOR_BLACK, LCD_COLOR_BLACK, 4, LCD_COLOR_BLACK, ""),
 };
+/* resampleWindow(void)
+ *      Fills the fft input buffer with the raw window resampled onto the nominal grid and prints
+ *      the jitter of the window
+ * @returns None
+ */
+void resampleWindow(void) {
+    const JitterStats& jitter = resampler.measure(sample_times, FFT_SIZE);
+    resample_cycles.start();
+    resampler.resample(sample_times, raw_samples, FFT_SIZE, fft_input, 2);
+    resample_cycles.stop();
+    for (int i = 0; i < FFT_SIZE; i++) {
+        fft_input[i * 2 + 1] = 0;
+    }
+    // Noise floor that this much timing jitter would leave at 5 hz without resampling
+    float phase_error = 2.0f * PI * 5.0f * jitter.rms_grid_error;
+    printf("Jitter: interval %f ms (std %f, min %f, max %f) grid rms %f ms gaps %lu\n",
+           jitter.mean_interval * 1e3f, jitter.std_interval * 1e3f, jitter.min_interval * 1e3f,
+           jitter.max_interval * 1e3f, jitter.rms_grid_error * 1e3f, jitter.gaps);
+    printf("Jitter: uncorrected freq error %+.2f%% (%+f hz at 5 hz), floor %.1f dB, resample %lu cycles\n",
+           resampler.frequencyScaleError() * 100.0f, resampler.frequencyScaleError() * 5.0f,
+           phase_error > 0.0f ? 20.0f * log10f(phase_error) : -99.0f, resample_cycles.last);
+}
+/* bandpassGrid(void)
+ *      Band-passes the resampled window (after resampleWindow()) into band_samples
+ * @returns None
+ */
+void bandpassGrid(void) {
+    for (int i = 0; i < FFT_SIZE; i++) {
+        band_samples[i] = fft_input[i * 2];
+    }
+    grid_bandpass.process(band_samples, band_samples, FFT_SIZE);
+}
+// Hardware timestamp of the first sample of the current window
+uint32_t window_start_us = 0;
+/* processSample(xyz, timestamp_us, i)
+ *      Stores sample i of the window with its timestamp and streams it through the per-sample stages
+ * @returns None
+ */
+void processSample(const std::array<float, 3>& xyz, uint32_t timestamp_us, int i) {
+    if (i == 0) {
+        window_start_us = timestamp_us;
+#if AXIS_COHERENCE && !CONTINUOUS_SAMPLING
+        // A segment straddling the pause would mix samples from before and after it
+        coherence.reset();
+#endif
+    }
+    deadlines.begin(STAGE_SAMPLE);
+    sample_times[i] = (timestamp_us - window_start_us) * 1e-6f;
+    raw_samples[i] = xyz[0];
+    amplitude.update(xyz[0]);
+#if RUN_TKEO
+    tkeo_cycles.start();
+    tkeo.update(amplitude.band);
+    tkeo_cycles.stop();
+#endif
+#if RUN_DWT
+    wavelet_cycles.start();
+    wavelet.update(xyz[0]);
+    wavelet_cycles.stop();
+#endif
+#if AXIS_COHERENCE
+    coherence_cycles.start();
+    coherence.update(xyz[0], xyz[1], xyz[2]);
+    coherence_cycles.stop();
+#endif
+    if (hilbert.update(amplitude.band) && window_hop_count < FFT_SIZE / HILBERT_HOP)
+        window_hops[window_hop_count++] = hilbert.stats;
+    deadlines.end(STAGE_SAMPLE);
+    // printf(">x:%f\n", xyz[0]);
+}
+/* logHops(void)
+ *      Prints the Hilbert statistics of every hop of the window as amp/max rad/s, freq hz and burst fraction
+ * @returns None
+ */
+void logHops(void) {
+    printf("Hops:");
+    for (uint32_t h = 0; h < window_hop_count; h++) {
+        printf(" %.2f/%.2f %.2fhz %.2f", window_hops[h].mean_amplitude, window_hops[h].max_amplitude,
+               window_hops[h].mean_frequency, window_hops[h].burst_fraction);
+    }
+    printf("\n");
+    window_hop_count = 0;
+}
+/* closeWindow(void)
+ *      Finishes the streaming stages once FFT_SIZE samples were processed and fills the fft input buffer
+ * @returns None
+ */
+void closeWindow(void) {
+    amplitude.endWindow();
+#if RUN_TKEO
+    tkeo.endWindow();
+#endif
+#if RUN_DWT
+    wavelet.endWindow();
+#endif
+#if AXIS_COHERENCE
+    coherence.endWindow();
+#endif
+    resampleWindow();
+#if RUN_ESPRIT || RUN_VOCODER
+#if !CONTINUOUS_SAMPLING
+    // The previous window's tail is separated from this one by the analysis pause
+    grid_bandpass.reset();
+#endif
+    bandpassGrid();
+#endif
+#if RUN_VOCODER
+#if !CONTINUOUS_SAMPLING
+    // Frames straddling the pause would give a meaningless phase advance
+    vocoder.reset();
+#endif
+    for (int i = 0; i < FFT_SIZE; i++) {
+        vocoder_cycles.start();
+        vocoder.update(band_samples[i]);
+        vocoder_cycles.stop();
+    }
+    vocoder.endWindow();
+#endif
+    logHops();
+    deadlines.print();
+    cpu_load.print();
+#ifdef CLOCK_GOVERNOR
+    governor.printStats();
+#endif
+}
+/* setClockLevel(level)
+ *      Switches the core clock when the governor is built in, and keeps the deadline monitor in step
+ * @returns None
+ */
+void setClockLevel(ClockLevel level) {
+#ifdef CLOCK_GOVERNOR
+    governor.set(level);
+    deadlines.clock_shift = governor.shift();
+#endif
+}
+/* beginAcquisition(void)
+ *      Starts measuring wakeups and awake time of a window fill
+ * @returns None
+ */
+void beginAcquisition(void) {
+    mbed_stats_cpu_get(&acquisition_start);
+    acquisition_wakeups = 0;
+}
+/* endAcquisition(void)
+ *      Prints the wakeups per second and the duty cycle (awake share) of the window fill
+ * @returns None
+ */
+void endAcquisition(void) {
+    mbed_stats_cpu_t now;
+    mbed_stats_cpu_get(&now);
+    us_timestamp_t elapsed = now.uptime - acquisition_start.uptime;
+    us_timestamp_t idle = now.idle_time - acquisition_start.idle_time;
+    if (elapsed == 0)
+        return;
+    printf("Acquisition: %.1f wakeups/s, duty cycle %.1f%% over %.2f s\n", acquisition_wakeups * 1e6f / elapsed,
+           idle < elapsed ? 100.0f * (elapsed - idle) / elapsed : 0.0f, elapsed * 1e-6f);
+}
+#ifdef TREMOR_LOW_POWER
+/* fifoWatermark(void)
+ *      INT2 interrupt: the gyroscope FIFO reached FIFO_WATERMARK samples
+ * @returns None
+ */
+void fifoWatermark(void) {
+    fifo_ready = true;
+}
+/* waitForFifo(void)
+ *      Sleeps until the FIFO watermark or any other interrupt, reads the FIFO if it is due, then queues
+ *      touches and polls the load meter
+ * @returns uint32_t number of samples read into fifo_xyz, 0 if woken by something else
+ */
+uint32_t waitForFifo(void) {
+    // Same critical section as the scheduler: an interrupt after the check still wakes the core
+    core_util_critical_section_enter();
+    if (!fifo_ready) {
+        sleep_manager_sleep_auto();
+        acquisition_wakeups++;
+    }
+    core_util_critical_section_exit();
+    uint32_t n = 0;
+    if (fifo_ready) {
+        fifo_ready = false;
+        n = fifo_gyro->readFifo(fifo_xyz);
+        deadlines.period(STAGE_ACQUIRE);
+    }
+    // Touches wake the core as well, queue them
+    gui.serviceTouch();
+    updateLoad();
+    return n;
+}
+#ifdef ADAPTIVE_SAMPLING
+/* setAcquireBudget(odr_hz)
+ *      Sets the acquire budget for a FIFO data rate. Called at CLOCK_LOW, so the budget is converted with
+ *      the clock the other budgets were set at rather than through setBudget()
+ * @returns None
+ */
+void setAcquireBudget(uint32_t odr_hz) {
+    deadlines.stages[STAGE_ACQUIRE].budget = FIFO_BUDGET_US(odr_hz) * (deadlines.clock_hz / 1000000);
+}
+/* watchForActivity(void)
+ *      Watch mode: runs only the activity detector on the low rate stream and keeps the last grid samples
+ *      as pre-trigger history. On activity it switches the gyroscope to the capture rate and opens the
+ *      window with the history.
+ * @returns int samples of the window already filled, -1 if watching was given up for a touch
+ */
+int watchForActivity(void) {
+    gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "WATCHING...", CENTER_MODE);
+    GyroSample history[PRETRIGGER_SAMPLES];
+    // History from an earlier watch has a gap to what follows
+    pretrigger.pop(history, PRETRIGGER_SAMPLES);
+    bool triggered = false;
+    while (!triggered) {
+        // The menu only runs between windows, stop watching as soon as it has something to do
+        if (!gui.touch_events.empty() || (gui.state != TREMOR_DETECTION && gui.state != FREQ_VIEW))
+            return -1;
+        uint32_t n = waitForFifo();
+        for (uint32_t k = 0; k < n; k++) {
+            if (rate_converter.update(fifo_xyz[k], fifo_gyro->fifoSampleTime(k, n))) {
+                GyroSample sample = {rate_converter.output_us, rate_converter.output};
+                pretrigger.push(sample);
+                triggered = activity.update(sample.xyz) || triggered;
+            }
+        }
+    }
+
+    // The grid continues across the switch, only the FIFO restarts
+    fifo_gyro->setFifoRate(CTRL_REG1_FIFO_FAST_CONFIG, GYRO_FIFO_FAST_ODR_HZ, FIFO_WATERMARK);
+    fifo_ready = false;
+    setAcquireBudget(GYRO_FIFO_FAST_ODR_HZ);
+    deadlines.restart(STAGE_ACQUIRE);
+    uint32_t now_us = us_ticker_read();
+    watch_us += now_us - mode_start_us;
+    mode_start_us = now_us;
+    capturing = true;
+
+    pretrigger_used = pretrigger.pop(history, PRETRIGGER_SAMPLES);
+    for (uint32_t k = 0; k < pretrigger_used; k++) {
+        processSample(history[k].xyz, history[k].timestamp_us, k);
+    }
+    gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "SAMPLING...", CENTER_MODE);
+    return pretrigger_used;
+}
+/* endCapture(void)
+ *      Drops back to the watch rate once the activity is over, and prints the time in each mode
+ * @returns None
+ */
+void endCapture(void) {
+    if (!activity.active) {
+        fifo_gyro->setFifoRate(CTRL_REG1_FIFO_CONFIG, GYRO_FIFO_ODR_HZ, WATCH_WATERMARK);
+        setAcquireBudget(GYRO_FIFO_ODR_HZ);
+        uint32_t now_us = us_ticker_read();
+        capture_us += now_us - mode_start_us;
+        mode_start_us = now_us;
+        capturing = false;
+    }
+    printf("Adaptive: %s, activity %.3f rad/s (on %.2f off %.2f), %lu triggers, pre-trigger %lu samples, watching %.1f s capturing %.1f s\n",
+           capturing ? "capturing" : "watching", activity.rms, ACTIVITY_ON_RMS, ACTIVITY_OFF_RMS, activity.triggers,
+           pretrigger_used, watch_us * 1e-6f, capture_us * 1e-6f);
+}
+#endif
+/* fillFFTWindow(void)
+ *      Low power acquisition: the gyroscope collects samples in its FIFO at 95 Hz while the MCU sleeps,
+ *      and every watermark interrupt burst reads the FIFO and streams the samples, interpolated onto
+ *      the SAMPLING_FREQ grid, through the pipeline. No timer runs while sampling. With ADAPTIVE_SAMPLING
+ *      the window only starts once the activity detector fires, and is then sampled at 190 Hz onto the
+ *      same grid.
+ * @returns None
+ */
+void fillFFTWindow(void) {
+    gui.lcd.SetBackColor(LCD_COLOR_BLACK);
+    gui.lcd.SetTextColor(LCD_COLOR_GREEN);
+    gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "SAMPLING...", CENTER_MODE);
+    setClockLevel(CLOCK_LOW);
+    beginAcquisition();
+    // Samples collected while the last window was analyzed are stale, start with an empty FIFO
+    fifo_gyro->restartFifo();
+    fifo_ready = false;
+    rate_converter.reset();
+    deadlines.restart(STAGE_ACQUIRE);
+    int i = 0;
+#ifdef ADAPTIVE_SAMPLING
+    if (!capturing)
+        i = watchForActivity();
+    if (i < 0) {
+        window_filled = false;
+        setClockLevel(CLOCK_BOOST);
+        gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "           ", CENTER_MODE);
+        return;
+    }
+#endif
+    while (i < FFT_SIZE) {
+        uint32_t n = waitForFifo();
+        for (uint32_t k = 0; k < n && i < FFT_SIZE; k++) {
+            if (rate_converter.update(fifo_xyz[k], fifo_gyro->fifoSampleTime(k, n))) {
+                velocity_xyz = rate_converter.output;
+#ifdef ADAPTIVE_SAMPLING
+                activity.update(velocity_xyz);
+#endif
+                processSample(velocity_xyz, rate_converter.output_us, i++);
+            }
+        }
+    }
+    endAcquisition();
+    setClockLevel(CLOCK_BOOST);
+    printf("Acquisition: fifo %lu samples in %lu reads, odr %.2f hz, overruns %lu, grid points skipped %lu\n",
+           fifo_gyro->fifo_samples, fifo_gyro->fifo_reads, 1e6f / fifo_gyro->fifo_period_us,
+           fifo_gyro->fifo_overruns, rate_converter.skipped);
+#ifdef ADAPTIVE_SAMPLING
+    endCapture();
+#endif
+    window_filled = true;
+    closeWindow();
+    gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "           ", CENTER_MODE);
+}
+#else
 /* fillFFTWindow(void)
  *  Collects data from the gyroscope at specific frequency to fill the fft input buffer 
  * @returns None
@@ -106,25 +691,164 @@ void fillFFTWindow(void) {
     gui.lcd.SetBackColor(LCD_COLOR_BLACK);
     gui.lcd.SetTextColor(LCD_COLOR_GREEN);
     gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "SAMPLING...", CENTER_MODE);
+    setClockLevel(CLOCK_LOW);
+    beginAcquisition();
     //Create gyroscope instance
     Gyroscope gyro;
+    // Sampling was paused on purpose while the last window was analyzed, that is no late read
+    deadlines.restart(STAGE_ACQUIRE);
     // Fill sample with values
     for(int i = 0; i < FFT_SIZE; i++) {
         velocity_xyz = gyro.sequential_read();
-        fft_input[i*2] = velocity_xyz[0];
-        fft_input[i * 2 + 1] = 0;
-        // printf(">x:%f\n", velocity_xyz[0]);
+        deadlines.period(STAGE_ACQUIRE);
+        processSample(velocity_xyz, gyro.timestamp_us, i);
+        // Queue touches made while sampling, they are handled once the window is done
+        gui.serviceTouch();
+        updateLoad();
         thread_sleep_for(SAMPLING_FREQ);
+        acquisition_wakeups++;
     }
     gyro.endSPI();
+    endAcquisition();
+    setClockLevel(CLOCK_BOOST);
+    closeWindow();
     //memcpy(fft_input, fft_window, FFT_SIZE * 2);
     gui.lcd.DisplayStringAt(0, 150, (uint8_t *) "           ", CENTER_MODE);
 }
+#endif
+/* computeEmbedding(void)
+ *      Reduces the raw window in fft_input to cepstral coefficients. Must run before
+ *      fourierTransform(), which overwrites the samples in place.
+ * @returns Pointer to EMBEDDING_SIZE coefficients
+ */
+const float32_t* computeEmbedding(void) {
+    return embedding.compute(fft_input, 2);
+}
+/* logEmbedding(void)
+ *      Prints the last computed embedding over serial
+ * @returns None
+ */
+void logEmbedding(void) {
+    printf("Embedding:");
+    for (int i = 0; i < EMBEDDING_SIZE; i++) {
+        printf(" %.3f", embedding.coefficients[i]);
+    }
+    printf("\n");
+}
+/* matchTemplates(void)
+ *      Matches the raw window in fft_input against the DTW template library. Must run before
+ *      fourierTransform(), which overwrites the samples in place.
+ * @returns float frequency of the matched tremor template, 0 if none matched
+ */
+float matchTemplates(void) {
+    matcher_cycles.start();
+    matcher.prepareQuery(fft_input, FFT_SIZE, 2);
+    matcher.match();
+    matcher_cycles.stop();
+    return matcher.matchedTremor() ? matcher.matchedFrequency() : 0.0f;
+}
+/* logTemplates(void)
+ *      Prints the last template match with its cycle cost
+ * @returns None
+ */
+void logTemplates(void) {
+    printf("DTW template: %ld distance: %f cycles: %lu (worst %lu, %lu cells/template)\n",
+           matcher.best_template, matcher.best_distance, matcher_cycles.last, matcher_cycles.worst, TemplateMatcher::bandCells());
+}
+/* lombScargle(void)
+ *      Evaluates the Lomb-Scargle periodogram of the raw window over the 2-8 hz band using the measured
+ *      sample times
+ * @returns float frequency of the band peak
+ */
+float lombScargle(void) {
+    lomb_cycles.start();
+    float peak = lomb.compute(sample_times, raw_samples, FFT_SIZE, 2.0f, 8.0f);
+    lomb_cycles.stop();
+    return peak;
+}
+/* logLombScargle(float)
+ *      Prints the last Lomb-Scargle peak with its cycle cost and the effective rate of the window
+ * @returns None
+ */
+void logLombScargle(float peak) {
+    float span = sample_times[FFT_SIZE - 1] - sample_times[0];
+    printf("Lomb-Scargle: %f hz power %f (%lu cycles) effective rate %f hz\n",
+           peak, lomb.peak_power, lomb_cycles.last, span > 0.0f ? (FFT_SIZE - 1) / span : 0.0f);
+}
+/* subspaceEstimate(void)
+ *      Runs ESPRIT on the full band-passed window from a cold start, with ESTIMATOR_BENCHMARK also on the
+ *      most recent 32, 64 and 128 samples, and keeps estimate and signal fraction of each length
+ * @returns float frequency estimated from the full window
+ */
+float subspaceEstimate(void) {
+    for (int i = SUBSPACE_FIRST_LENGTH; i < SUBSPACE_BENCH_LENGTHS; i++) {
+        uint32_t length = SUBSPACE_LENGTHS[i];
+        subspace.reset(SAMPLE_RATE_HZ);
+        subspace_cycles[i].start();
+        subspace.estimate(band_samples + FFT_SIZE - length, length);
+        subspace_cycles[i].stop();
+        subspace_frequency[i] = subspace.frequency;
+        subspace_fraction[i] = subspace.signal_fraction;
+    }
+    return subspace.frequency;
+}
+/* logSubspace(void)
+ *      Prints estimate, signal fraction and cycles of every ESPRIT length of the last window
+ * @returns None
+ */
+void logSubspace(void) {
+    printf("ESPRIT (order %d):", SUBSPACE_MAX_ORDER);
+    for (int i = SUBSPACE_FIRST_LENGTH; i < SUBSPACE_BENCH_LENGTHS; i++) {
+        printf(" [%lu] %f hz %.2f %lu cycles (worst %lu)", SUBSPACE_LENGTHS[i], subspace_frequency[i],
+               subspace_fraction[i], subspace_cycles[i].last, subspace_cycles[i].worst);
+    }
+    printf("\n");
+}
+/* benchmarkSpectra(void)
+ *      Estimates the spectrum of the window with the periodogram, Welch and the multitaper PSD. Must run
+ *      before fourierTransform(), which overwrites the samples in place.
+ * @returns None
+ */
+void benchmarkSpectra(void) {
+    periodogram_cycles.start();
+    multitaper.periodogram(fft_input, 2, periodogram_psd);
+    periodogram_cycles.stop();
+    welch_cycles.start();
+    multitaper.welch(fft_input, 2, welch_psd);
+    welch_cycles.stop();
+    multitaper_cycles.start();
+    multitaper.compute(fft_input, 2);
+    multitaper_cycles.stop();
+}
+/* logSpectra(void)
+ *      Prints the bin to bin variability of each benchmarked spectrum over a background band with its
+ *      cycle cost
+ * @returns None
+ */
+void logSpectra(void) {
+    uint32_t first = SPECTRUM_BENCH_LOW_HZ * FFT_SIZE / SAMPLE_RATE_HZ;
+    uint32_t last = SPECTRUM_BENCH_HIGH_HZ * FFT_SIZE / SAMPLE_RATE_HZ;
+    uint32_t welch_first = SPECTRUM_BENCH_LOW_HZ * WELCH_SEGMENT / SAMPLE_RATE_HZ;
+    uint32_t welch_last = SPECTRUM_BENCH_HIGH_HZ * WELCH_SEGMENT / SAMPLE_RATE_HZ;
+    printf("Spectra: variability periodogram %.3f (%lu cycles) welch %.3f (%lu cycles, 4x coarser) multitaper %.3f (%lu cycles)\n",
+           Multitaper::variability(periodogram_psd, first, last), periodogram_cycles.last,
+           Multitaper::variability(welch_psd, welch_first, welch_last), welch_cycles.last,
+           Multitaper::variability(multitaper.psd, first, last), multitaper_cycles.last);
+}
 /* fourierTransform(void)
- *      Performs a fourier transform on the input buffer, calculates maximum energy bin, and returns the frequency
+ *      Performs a fourier transform on the input buffer, calculates maximum energy bin, and returns the frequency.
+ *      In multitaper mode the magnitudes are derived from the multitaper PSD on the periodogram's scale.
  * @returns float freqeuncy of signal
  */
 float fourierTransform(void) {
+    fft_cycles.start();
+#if SPECTRUM_MODE == SPECTRUM_MULTITAPER
+    multitaper.compute(fft_input, 2);
+    for (uint32_t k = 0; k < MULTITAPER_BINS; k++) {
+        arm_sqrt_f32(FFT_SIZE * multitaper.psd[k], &fft_output[k]);
+        fft_output[(FFT_SIZE - k) % FFT_SIZE] = fft_output[k];
+    }
+#else
     /* Process the data through the CFFT/CIFFT module */
     //printf("Processing Data\n");
     arm_cfft_f32(&fft, fft_input, ifftFlag, doBitReverse);
@@ -133,18 +857,119 @@ float fourierTransform(void) {
     calculating the magnitude at each bin */
     //printf("Computing Complex Magnitude\n");
     arm_cmplx_mag_f32(fft_input, fft_output, FFT_SIZE);
+#endif
 
     /* Calculates maxValue and returns corresponding BIN value */
     //printf("Getting Maximum energy bin\n");
     arm_max_f32(fft_output, FFT_SIZE, &fft_maxValue, &fft_maxIndex);
-    //printf("Max Val: %f\n", fft_maxValue);
-    printf("Max Index: %lu\n", fft_maxIndex);
+    fft_cycles.stop();
 
     /* Calculate frequency of maximum energy bin -> based on index in sample and sample rate */
-    float maxFreqComponent = static_cast<float>(fft_maxIndex) * (static_cast<float>(SAMPLING_FREQ) / FFT_SIZE);
-    printf("Frequency:%f\n", maxFreqComponent);
+    float maxFreqComponent = static_cast<float>(fft_maxIndex) * (SAMPLE_RATE_HZ / FFT_SIZE);
     return maxFreqComponent;
 }
+/* logPeak(float)
+ *      Prints the maximum energy bin of the last fourier transform and its frequency
+ * @returns None
+ */
+void logPeak(float freq) {
+    //printf("Max Val: %f\n", fft_maxValue);
+    printf("Max Index: %lu\n", fft_maxIndex);
+    printf("Frequency:%f\n", freq);
+}
+/* compareEstimators(float)
+ *      Prints the FFT, Teager-Kaiser and wavelet frequency estimates of the same window with their cycle cost
+ * @returns None
+ */
+void compareEstimators(float fft_freq) {
+    printf("Estimators: fft %f hz (%lu cycles/window) tkeo %f hz (%lu cycles/window, %lu/sample) diff %f hz\n",
+           fft_freq, fft_cycles.last, tkeo.window_frequency, tkeo_cycles.average() * FFT_SIZE, tkeo_cycles.average(),
+           tkeo.window_frequency - fft_freq);
+    printf("Estimators: dwt %f hz, 3-6 hz fraction %f (%lu cycles/window) diff %f hz\n",
+           wavelet.dominantFrequency(2.0f, 8.4f), wavelet.bandFraction(3.0f, 6.3f), wavelet_cycles.average() * FFT_SIZE,
+           wavelet.dominantFrequency(2.0f, 8.4f) - fft_freq);
+}
+/* fundamentalFrequency(void)
+ *      Estimates the fundamental of the current magnitude spectrum (after fourierTransform())
+ * @returns float fundamental frequency
+ */
+float fundamentalFrequency(void) {
+    fundamental_cycles.start();
+    float f0 = fundamental.estimate(fft_output);
+    fundamental_cycles.stop();
+    return f0;
+}
+/* logFundamental(float, float)
+ *      Prints the last fundamental estimate with its cycle cost, flagging an FFT peak on a harmonic
+ * @returns None
+ */
+void logFundamental(float fft_freq, float f0) {
+    printf("Fundamental: %f hz harmonicity %.2f harmonics %lu (%lu cycles)%s\n", f0, fundamental.harmonicity,
+           fundamental.harmonics_found, fundamental_cycles.last, fft_freq > 1.5f * f0 ? " fft peak is a harmonic" : "");
+}
+/* logCoherence(void)
+ *      Prints coherence and phase of every axis pair at the tremor band peak of the last window
+ * @returns None
+ */
+void logCoherence(void) {
+    printf("Coherence: %f hz over %lu segments (%lu cycles/window)", coherence.peak_hz, coherence.window_segments,
+           coherence_cycles.average() * FFT_SIZE);
+    for (int p = 0; p < COHERENCE_PAIRS; p++) {
+        printf(" %s %.2f %.0fdeg", PAIR_NAMES[p], coherence.coherence[p], coherence.phase_deg[p]);
+    }
+    printf("%s\n", coherence.coherent ? " coherent" : "");
+}
+/* spectrumChanged(void)
+ *      Compares the current magnitude spectrum (after fourierTransform()) with the last processed one
+ *      and reports the skip ratio
+ * @returns bool true if downstream work should run for this window
+ */
+bool spectrumChanged(void) {
+    bool changed = change_detector.update(fft_output, FFT_SIZE / 2);
+    printf("Change: %f skipped %lu/%lu (%.1f%%)\n", change_detector.last_distance,
+           change_detector.skipped, change_detector.windows, change_detector.skipRatio() * 100.0f);
+    return changed;
+}
+/* Tremor intensity from the averaged dominant frequency */
+enum INTENSITY {
+    INTENSITY_NONE,
+    INTENSITY_LOW,
+    INTENSITY_MID,
+    INTENSITY_HIGH
+};
+/* classifyThreshold(float)
+ *      Maps the averaged frequency to a tremor intensity with fixed thresholds
+ * @returns INTENSITY of the tremor
+ */
+INTENSITY classifyThreshold(float avg_freq) {
+    if(avg_freq >= 5.0f && avg_freq <= 6.0f)
+        return INTENSITY_HIGH;
+    else if(avg_freq >= 4.0f && avg_freq < 5.0f)
+        return INTENSITY_MID;
+    else if(avg_freq >= 3.0f && avg_freq < 4.0f)
+        return INTENSITY_LOW;
+    return INTENSITY_NONE;
+}
+/* classifyBayes(void)
+ *      Runs the naive Bayes classifier on the current magnitude spectrum (after fourierTransform()) and
+ *      the cepstral embedding of the same window (after computeEmbedding())
+ * @returns TremorClass most likely class, probabilities are left in classifier.probabilities
+ */
+TremorClass classifyBayes(void) {
+    extractTremorFeatures(fft_output, FFT_SIZE, SAMPLE_RATE_HZ / FFT_SIZE, embedding.coefficients, tremor_features);
+    return classifier.classify(tremor_features);
+}
+/* logFeatures(void)
+ *      Prints the feature vector of the last classified window, the training input of tools/train_gnb.py
+ * @returns None
+ */
+void logFeatures(void) {
+    printf("Features:");
+    for (int i = 0; i < TREMOR_NUM_FEATURES; i++) {
+        printf(" %.5f", tremor_features[i]);
+    }
+    printf("\n");
+}
 /************************************
  * FREQUENCY VIEW STATE
  * Displays raw frequency spectrum from a fourier transform on gyroscope data
@@ -169,6 +994,804 @@ std::vector<Region*> INFO_UI = {
     new RectRegion(0, 40, 240, 280, LCD_COLOR_BLACK, LCD_COLOR_BLACK, 4, LCD_COLOR_BLACK, ""),
 };
 
+/************************************
+ * WINDOW PROCESSING
+ * Analysis of a completed window and the LCD drawing of its result, kept apart so the drawing never
+ * reads the DSP buffers directly and both halves can run on different threads
+ */
+struct WindowResult {
+    bool changed = true;                 // false if the spectrum matched the last processed window
+    float freq = 0.0f;                   // detector frequency of this window
+    float avg_freq = 0.0f;               // moving average used for the intensity
+    INTENSITY intensity = INTENSITY_NONE;
+    TremorClass tremor_class = CLASS_QUIET;
+    float confidence = 0.0f;
+    float amplitude_deg = 0.0f;          // peak-to-peak rotation
+    float amplitude_rms = 0.0f;          // band rms in rad/s
+    float spectrum[FFT_SIZE / 2] = {0};  // magnitude spectrum for the frequency view
+    float spectrum_max = 1.0f;
+    uint32_t spectrum_peak = 0;
+};
+WindowResult window_result;
+/* copySpectrum(result)
+ *      Copies the one-sided magnitude spectrum and its peak (after fourierTransform()) into the result
+ * @returns None
+ */
+void copySpectrum(WindowResult& result) {
+    memcpy(result.spectrum, fft_output, sizeof(result.spectrum));
+    result.spectrum_max = fft_maxValue > 0.0f ? fft_maxValue : 1.0f;
+    result.spectrum_peak = fft_maxIndex;
+}
+/* analyzeTremor(result)
+ *      Runs the full tremor pipeline on the window in fft_input and fills the result. Classification
+ *      and logging are skipped when the spectrum is unchanged, result.changed reports which.
+ * @returns None
+ */
+void analyzeTremor(WindowResult& result) {
+    deadlines.begin(STAGE_TRANSFORM);
+    // Summarize the raw window before the in place FFT
+    computeEmbedding();
+#if DETECTOR_MODE == DETECTOR_DTW
+    float dtw_freq = matchTemplates();
+#endif
+#if RUN_LOMB
+    float lomb_freq = lombScargle();
+#endif
+#if RUN_ESPRIT
+    float esprit_freq = subspaceEstimate();
+#endif
+#if ESTIMATOR_BENCHMARK
+    benchmarkSpectra();
+#endif
+
+    // Perform FFT
+    float freq = fourierTransform();
+    copySpectrum(result);
+#if RUN_HPS
+    float f0 = fundamentalFrequency();
+#endif
+    deadlines.end(STAGE_TRANSFORM);
+
+    // Logging of the estimators, outside the transform budget
+#if DETECTOR_MODE == DETECTOR_DTW
+    logTemplates();
+#endif
+#if RUN_LOMB
+    logLombScargle(lomb_freq);
+#endif
+#if RUN_ESPRIT
+    logSubspace();
+#endif
+#if ESTIMATOR_BENCHMARK
+    logSpectra();
+#endif
+    logPeak(freq);
+#if ESTIMATOR_BENCHMARK
+    compareEstimators(freq);
+#endif
+#if RUN_HPS
+    logFundamental(freq, f0);
+#endif
+#if ESTIMATOR_BENCHMARK
+    printf("Estimators: lomb %f hz diff %f hz, esprit %f hz diff %f hz\n", lomb_freq, lomb_freq - freq,
+           esprit_freq, esprit_freq - freq);
+    printf("Estimators: vocoder %f hz (%lu cycles/window, worst frame %lu) diff %f hz\n", vocoder.window_frequency,
+           vocoder_cycles.average() * FFT_SIZE, vocoder_cycles.worst, vocoder.window_frequency - freq);
+#endif
+#if DETECTOR_MODE == DETECTOR_DTW
+    freq = dtw_freq;
+#elif DETECTOR_MODE == DETECTOR_TKEO
+    freq = tkeo.window_frequency;
+#elif DETECTOR_MODE == DETECTOR_DWT
+    freq = wavelet.dominantFrequency(2.0f, 8.4f);
+#elif DETECTOR_MODE == DETECTOR_LOMB
+    freq = lomb_freq;
+#elif DETECTOR_MODE == DETECTOR_ESPRIT
+    freq = esprit_freq;
+#elif DETECTOR_MODE == DETECTOR_VOCODER
+    freq = vocoder.window_frequency;
+#elif DETECTOR_MODE == DETECTOR_HPS
+    freq = f0;
+#endif
+    result.freq = freq;
+
+    // Nothing new to classify, log or draw
+    result.changed = spectrumChanged();
+    if (!result.changed)
+        return;
+    logEmbedding();
+#if AXIS_COHERENCE
+    logCoherence();
+#endif
+
+    // Apply moving average and threshold classification. With AXIS_COHERENCE a coherent multi-axis
+    // oscillation in the tremor range is decided on this window alone instead of waiting for the average
+    deadlines.begin(STAGE_CLASSIFY);
+    threshold_cycles.start();
+#if AXIS_COHERENCE
+    if (coherence.coherent && classifyThreshold(freq) != INTENSITY_NONE)
+        moving_avg_freq.clear();
+#endif
+    moving_avg_freq.update(freq);
+    result.avg_freq = moving_avg_freq.getAverage();
+    result.intensity = classifyThreshold(result.avg_freq);
+    threshold_cycles.stop();
+
+    // Naive Bayes classification on the same window
+    classifier_cycles.start();
+    result.tremor_class = classifyBayes();
+    classifier_cycles.stop();
+    result.confidence = classifier.confidence();
+    deadlines.end(STAGE_CLASSIFY);
+    logFeatures();
+    printf("Cycles threshold: %lu (worst %lu) bayes: %lu (worst %lu)\n",
+           threshold_cycles.last, threshold_cycles.worst, classifier_cycles.last, classifier_cycles.worst);
+
+    result.amplitude_deg = amplitude.peak_to_peak_deg;
+    result.amplitude_rms = amplitude.band_rms;
+    printf("Amplitude: %f deg p-p, %f rad/s rms\n", amplitude.peak_to_peak_deg, amplitude.band_rms);
+}
+/* analyzeSpectrum(result)
+ *      Transforms the window in fft_input and fills the frequency view part of the result
+ * @returns None
+ */
+void analyzeSpectrum(WindowResult& result) {
+    deadlines.begin(STAGE_TRANSFORM);
+    result.freq = fourierTransform();
+    deadlines.end(STAGE_TRANSFORM);
+    logPeak(result.freq);
+    copySpectrum(result);
+    result.changed = spectrumChanged();
+}
+/* setupDeadlines(void)
+ *      Sets the stage budgets (after the core clock is final), prints the monitoring cost and starts
+ *      the load meter
+ * @returns None
+ */
+void setupDeadlines(void) {
+    deadlines.setBudget(STAGE_ACQUIRE, "acquire", ACQUIRE_BUDGET_US);
+    deadlines.setBudget(STAGE_TRANSFORM, "transform", TRANSFORM_BUDGET_US);
+    deadlines.setBudget(STAGE_CLASSIFY, "classify", CLASSIFY_BUDGET_US);
+    deadlines.setBudget(STAGE_DRAW, "draw", DRAW_BUDGET_US);
+    deadlines.setBudget(STAGE_SAMPLE, "sample", SAMPLE_BUDGET_US);
+    printf("Deadline: monitoring costs %lu cycles per stage\n", deadlines.overhead());
+    cpu_load.start();
+}
+/* drawDeadlineOverlay(void)
+ *      Draws the miss count of every stage next to the back button
+ * @returns None
+ */
+void drawDeadlineOverlay(void) {
+    char miss_str[24];
+    sprintf(miss_str, "A%lu T%lu C%lu D%lu", deadlines.stages[STAGE_ACQUIRE].misses,
+            deadlines.stages[STAGE_TRANSFORM].misses, deadlines.stages[STAGE_CLASSIFY].misses,
+            deadlines.stages[STAGE_DRAW].misses);
+    BSP_LCD_SetFont(&Font12);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.SetTextColor(LCD_COLOR_ORANGE);
+    gui.lcd.DisplayStringAt(104, 48, (uint8_t *) miss_str, LEFT_MODE);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    BSP_LCD_SetFont(&Font24);
+}
+/* drawTremor(result)
+ *      Draws the averaged frequency, intensity, classifier decision and amplitude of a window
+ * @returns None
+ */
+void drawTremor(const WindowResult& result) {
+    deadlines.begin(STAGE_DRAW);
+    // Draw text with freq
+    char freq_str[8];
+    sprintf(freq_str, "%4.2f", result.avg_freq);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    gui.lcd.DisplayStringAt(0, 80, (uint8_t *) " Tremor Range:", LEFT_MODE);
+    //gui.lcd.DisplayStringAt(0, 110, (uint8_t *) "        ", CENTER_MODE);
+    gui.lcd.DisplayStringAt(10, 110, (uint8_t *) "[3.0, 6.0]", LEFT_MODE);
+    gui.lcd.DisplayStringAt(200, 110, (uint8_t *) "hz", LEFT_MODE);
+
+    // Draw classifier decision with its confidence
+    char class_str[16];
+    sprintf(class_str, "%-6s %3d%%", CLASS_NAMES[result.tremor_class], static_cast<int>(result.confidence * 100.0f));
+    gui.lcd.SetTextColor(result.tremor_class == CLASS_REST_TREMOR ? LCD_COLOR_ORANGE : LCD_COLOR_WHITE);
+    gui.lcd.DisplayStringAt(10, 176, (uint8_t *) class_str, LEFT_MODE);
+
+    // Draw rotation amplitude of the window below the status box
+    char amp_str[24];
+    sprintf(amp_str, "%5.1fdeg %5.2frad/s", result.amplitude_deg, result.amplitude_rms);
+    BSP_LCD_SetFont(&Font16);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    gui.lcd.DisplayStringAt(10, 302, (uint8_t *) amp_str, LEFT_MODE);
+    BSP_LCD_SetFont(&Font24);
+    
+    // Draw intensities
+    if(result.intensity == INTENSITY_HIGH){
+        RectRegion r(40, 200, 160, 100, LCD_COLOR_DARKRED, LCD_COLOR_BLACK, 4, LCD_COLOR_ORANGE, "");
+        r.draw(&(gui.lcd));
+        gui.lcd.SetBackColor(LCD_COLOR_DARKRED);
+        gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+        gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "HIGH", LEFT_MODE);
+    } 
+    else if(result.intensity == INTENSITY_MID){
+        RectRegion r(40, 200, 160, 100, LCD_COLOR_ORANGE, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
+        r.draw(&(gui.lcd));
+        gui.lcd.SetBackColor(LCD_COLOR_ORANGE);
+        gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+        gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "MID", LEFT_MODE);
+    } 
+    else if(result.intensity == INTENSITY_LOW){
+        RectRegion r(40, 200, 160, 100, LCD_COLOR_YELLOW, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
+        r.draw(&(gui.lcd));
+        gui.lcd.SetBackColor(LCD_COLOR_YELLOW);
+        gui.lcd.SetTextColor(LCD_COLOR_BLACK);
+        gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "LOW", LEFT_MODE);
+    } 
+    else {
+        RectRegion r(40, 200, 160, 100, LCD_COLOR_DARKGREEN, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
+        r.draw(&(gui.lcd));
+        gui.lcd.SetBackColor(LCD_COLOR_DARKGREEN);
+        gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+        gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "N/A", LEFT_MODE);
+    }
+    gui.lcd.DisplayStringAt(56, 210, (uint8_t *) "Status: ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(0, 234, (uint8_t *) "        ", CENTER_MODE);
+    gui.lcd.DisplayStringAt(56, 234, (uint8_t *)freq_str, LEFT_MODE);
+    gui.lcd.DisplayStringAt(140, 234, (uint8_t *) "hz", LEFT_MODE);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    deadlines.end(STAGE_DRAW);
+#if DEADLINE_OVERLAY
+    drawDeadlineOverlay();
+#endif
+}
+/* drawSpectrum(result)
+ *      Draws the peak frequency and the magnitude spectrum graph of a window
+ * @returns None
+ */
+void drawSpectrum(const WindowResult& result) {
+    deadlines.begin(STAGE_DRAW);
+    // Draw text with freq
+    char freq_str[8];
+    sprintf(freq_str, "%4.2f", result.freq);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    gui.lcd.DisplayStringAt(40, 80, (uint8_t *) "Freq:", LEFT_MODE);
+    gui.lcd.DisplayStringAt(0, 110, (uint8_t *) "        ", CENTER_MODE);
+    gui.lcd.DisplayStringAt(40, 110, (uint8_t *) freq_str, LEFT_MODE);
+    gui.lcd.DisplayStringAt(140, 110, (uint8_t *) "hz", LEFT_MODE);
+    
+    // Starting point for Graph
+    int y_max = 100;
+    int y_coord = 300;
+    int x_coord = 56;
+    // Draw Graph
+    for (uint32_t i = 0; i < FFT_SIZE/2; i++) {
+        int magnitude = y_max * result.spectrum[i] / result.spectrum_max;
+        if (magnitude > y_max) {
+            magnitude = y_max;
+        } else if (magnitude < 0) {
+            magnitude = 0;
+        }
+        
+        // Clear previous line
+        gui.lcd.SetTextColor(gui.background_color);
+        gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - y_max);
+        
+        // Draw new line
+        if (result.spectrum_peak == i) {
+            gui.lcd.SetTextColor(LCD_COLOR_CYAN);
+            gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - magnitude);
+        } else {
+            gui.lcd.SetTextColor(LCD_COLOR_DARKGREEN);
+            gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - magnitude);
+        }
+    }
+    deadlines.end(STAGE_DRAW);
+#if DEADLINE_OVERLAY
+    drawDeadlineOverlay();
+#endif
+}
+/* drawLoadGauge(void)
+ *      Draws the utilization of the last load period as a bar next to the back button, with a tick
+ *      at the peak so far
+ * @returns None
+ */
+void drawLoadGauge(void) {
+    char load_str[16];
+    sprintf(load_str, "CPU %3d%%", static_cast<int>(cpu_load.utilization + 0.5f));
+    BSP_LCD_SetFont(&Font12);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    gui.lcd.DisplayStringAt(LOAD_GAUGE_X, 12, (uint8_t *) load_str, LEFT_MODE);
+    BSP_LCD_SetFont(&Font24);
+
+    uint16_t fill = static_cast<uint16_t>(LOAD_GAUGE_WIDTH * cpu_load.utilization / 100.0f);
+    uint16_t peak = static_cast<uint16_t>(LOAD_GAUGE_WIDTH * cpu_load.peak / 100.0f);
+    if (fill > LOAD_GAUGE_WIDTH)
+        fill = LOAD_GAUGE_WIDTH;
+    if (peak >= LOAD_GAUGE_WIDTH)
+        peak = LOAD_GAUGE_WIDTH - 1;
+    if (fill > 0) {
+        if (cpu_load.utilization > 80.0f)
+            gui.lcd.SetTextColor(LCD_COLOR_RED);
+        else if (cpu_load.utilization > 50.0f)
+            gui.lcd.SetTextColor(LCD_COLOR_ORANGE);
+        else
+            gui.lcd.SetTextColor(LCD_COLOR_DARKGREEN);
+        gui.lcd.FillRect(LOAD_GAUGE_X, 28, fill, 12);
+    }
+    if (fill < LOAD_GAUGE_WIDTH) {
+        gui.lcd.SetTextColor(LCD_COLOR_DARKGRAY);
+        gui.lcd.FillRect(LOAD_GAUGE_X + fill, 28, LOAD_GAUGE_WIDTH - fill, 12);
+    }
+    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
+    gui.lcd.DrawVLine(LOAD_GAUGE_X + peak, 26, 16);
+}
+/* drawInfo(void)
+ *      Draws the device info and usage text
+ * @returns None
+ */
+void drawInfo(void) {
+    BSP_LCD_SetFont(&Font16);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.DisplayStringAt(10, 60, (uint8_t *) "This device collects", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 80, (uint8_t *) "gyroscope data and ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 100, (uint8_t *) "calculates the freq. ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 120, (uint8_t *) "of oscillation to ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 140, (uint8_t *) "detect Parkinsonian ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 160, (uint8_t *) "Tremors. ", LEFT_MODE);
+    gui.lcd.SetBackColor(LCD_COLOR_DARKGRAY);
+    gui.lcd.DisplayStringAt(10, 180, (uint8_t *) "Tremor Mode:", LEFT_MODE);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.DisplayStringAt(10, 200, (uint8_t *) "- Processes signal", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 220, (uint8_t *) "- Identifies resting", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 240, (uint8_t *) "tremor + intensity", LEFT_MODE);
+    gui.lcd.SetBackColor(LCD_COLOR_DARKGRAY);
+    gui.lcd.DisplayStringAt(10, 260, (uint8_t *) "Frequency Mode:", LEFT_MODE);
+    gui.lcd.SetBackColor(gui.background_color);
+    gui.lcd.DisplayStringAt(10, 280, (uint8_t *) "- Outputs raw ", LEFT_MODE);
+    gui.lcd.DisplayStringAt(10, 300, (uint8_t *) "frequency spectrum", LEFT_MODE);
+    BSP_LCD_SetFont(&Font24);
+    drawLoadGauge();
+}
+/* updateLoad(void)
+ *      Closes the load period when it is over and refreshes the gauge of the info screen. Cheap enough for
+ *      the sampling path, the last period is printed by closeWindow()
+ * @returns bool true if a period was completed
+ */
+bool updateLoad(void) {
+    if (!cpu_load.update())
+        return false;
+    if (gui.state == INFO)
+        drawLoadGauge();
+    return true;
+}
+
+#if defined(TREMOR_RTOS) || defined(TREMOR_EVENTS) || defined(TREMOR_COROUTINES)
+// A whole window (7.68 s, 4 KB). Analyzing and logging a window blocks the consumer for ~1.6 s in the
+// default build (mostly ~1.5 KB of serial output at 9600 baud) and ~3 s with ESTIMATOR_BENCHMARK
+#define SAMPLE_QUEUE_DEPTH FFT_SIZE
+// Samples handed to the DSP stages in blocks of up to this many
+#define SAMPLE_BLOCK 16
+// Wait-free handoff, the acquisition side never takes a lock
+RingBuffer<GyroSample, SAMPLE_QUEUE_DEPTH> sample_ring;
+#endif
+
+#ifdef TREMOR_RTOS
+/************************************
+ * RTOS PROFILE
+ * Acquisition, DSP and UI run as separate threads instead of one blocking loop:
+ *  | acquisition (realtime): reads the gyroscope every SAMPLING_FREQ ms on an absolute schedule
+ *  | dsp (normal): streams samples through the per-sample stages, analyzes every full window
+ *  | ui (below normal, the main thread): polls touch every UI_POLL_MS ms and draws results
+ * Threads only share data through the bounded queues below; a full queue drops the newest entry
+ * and counts it instead of blocking the producer.
+ */
+#define RESULT_QUEUE_DEPTH 2
+#define UI_POLL_MS 10
+// Set when sample_ring has new samples
+#define SAMPLE_READY_FLAG 1
+Mail<WindowResult, RESULT_QUEUE_DEPTH> result_mail;
+Thread acquisition_thread(osPriorityRealtime, 4096, nullptr, "acquisition");
+Thread dsp_thread(osPriorityNormal, 8192, nullptr, "dsp");
+// Written by the DSP thread only
+uint32_t result_drops = 0;
+// Last result received by the UI thread
+WindowResult ui_result;
+
+/* acquisitionTask(void)
+ *      Reads the gyroscope on a fixed schedule and posts every sample to the DSP thread. The SPI link
+ *      stays open, and the next wakeup is computed from the schedule, not from when this one finished.
+ * @returns None, never returns
+ */
+void acquisitionTask(void) {
+    Gyroscope gyro;
+    Kernel::Clock::time_point next = Kernel::Clock::now();
+    while (true) {
+        GyroSample sample;
+        sample.xyz = gyro.sequential_read();
+        sample.timestamp_us = gyro.timestamp_us;
+        deadlines.period(STAGE_ACQUIRE);
+        if (sample_ring.push(sample))
+            dsp_thread.flags_set(SAMPLE_READY_FLAG);
+        next += std::chrono::milliseconds(SAMPLING_FREQ);
+        ThisThread::sleep_until(next);
+    }
+}
+/* dspTask(void)
+ *      Consumes samples, analyzes every completed window and posts the result to the UI thread.
+ *      Samples keep arriving in the queue while a window is analyzed.
+ * @returns None, never returns
+ */
+void dspTask(void) {
+    GyroSample block[SAMPLE_BLOCK];
+    int i = 0;
+    while (true) {
+        // Stop at the end of the window, the rest stays queued for the next one
+        uint32_t n = sample_ring.pop(block, FFT_SIZE - i < SAMPLE_BLOCK ? FFT_SIZE - i : SAMPLE_BLOCK);
+        if (n == 0) {
+            ThisThread::flags_wait_any(SAMPLE_READY_FLAG);
+            continue;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            processSample(block[k].xyz, block[k].timestamp_us, i++);
+        }
+        if (i < FFT_SIZE)
+            continue;
+        i = 0;
+
+        closeWindow();
+        analyzeTremor(window_result);
+        printf("Threads: sample queue %lu/%lu overruns %lu, result drops %lu\n",
+               sample_ring.size(), sample_ring.capacity(), sample_ring.overruns(), result_drops);
+        WindowResult* result = result_mail.try_alloc();
+        if (result != nullptr) {
+            *result = window_result;
+            result_mail.put(result);
+        } else {
+            result_drops++;
+        }
+    }
+}
+/* uiTask(void)
+ *      Handles touch and draws the latest result of the current screen. A new screen is drawn from the
+ *      last received result right away instead of waiting for the next window.
+ * @returns None, never returns
+ */
+void uiTask(void) {
+    bool have_result = false;
+    int last_state = gui.state;
+    while (true) {
+        if (gui.getTouchEvent())
+            gui.update();
+
+        bool redraw = gui.state != last_state;
+        last_state = gui.state;
+        WindowResult* result = result_mail.try_get();
+        if (result != nullptr) {
+            ui_result = *result;
+            result_mail.free(result);
+            have_result = true;
+            redraw = redraw || ui_result.changed;
+        }
+
+        updateLoad();
+        if (redraw) {
+            switch(gui.state) {
+                case TREMOR_DETECTION:
+                    if (have_result)
+                        drawTremor(ui_result);
+                    break;
+                case FREQ_VIEW:
+                    if (have_result)
+                        drawSpectrum(ui_result);
+                    break;
+                case INFO:
+                    drawInfo();
+                    break;
+            }
+        }
+        ThisThread::sleep_for(std::chrono::milliseconds(UI_POLL_MS));
+    }
+}
+#endif
+
+#if defined(TREMOR_EVENTS) || defined(TREMOR_COROUTINES)
+/************************************
+ * INTERRUPT ACQUISITION
+ * A Ticker starts every gyroscope read and the SPI completion interrupt queues the sample, so sampling
+ * never waits for the code that processes it. Each profile defines sampleQueued() to wake its consumer.
+ */
+// Created in main(), its constructor waits for the configuration writes
+Gyroscope* isr_gyro = nullptr;
+Ticker sample_ticker;
+volatile bool read_in_flight = false;
+uint32_t sample_skips = 0;
+void sampleQueued(void);
+
+/* sampleReadDone(event)
+ *      SPI completion interrupt: queues the sample and wakes the consumer
+ * @returns None
+ */
+void sampleReadDone(int event) {
+    GyroSample sample;
+    sample.xyz = isr_gyro->readResult();
+    sample.timestamp_us = isr_gyro->timestamp_us;
+    deadlines.period(STAGE_ACQUIRE);
+    read_in_flight = false;
+    sample_ring.push(sample);
+    sampleQueued();
+}
+/* startSampleRead(void)
+ *      Ticker interrupt: starts the next gyroscope read unless the last one is still on the bus
+ * @returns None
+ */
+void startSampleRead(void) {
+    if (read_in_flight) {
+        sample_skips++;
+        return;
+    }
+    read_in_flight = true;
+    isr_gyro->startRead(sampleReadDone);
+}
+#endif
+
+#ifdef TREMOR_EVENTS
+/************************************
+ * EVENT PROFILE
+ * Bare-metal without blocking waits: samples arrive through the interrupt acquisition above, which
+ * posts the sensor event, and main() only dispatches events, sleeping in between:
+ *  | sensor (3): streams queued samples through the per-sample stages, posts fft on a full window
+ *  | touch  (2): polls the touchscreen every TOUCH_POLL_MS ms
+ *  | fft    (1): analyzes the window for the current screen, posts redraw if it changed
+ *  | redraw (0): draws the last result of the current screen
+ *  | stats  (0): prints latency and deadline statistics every STATS_PERIOD_MS ms
+ * Sampling runs entirely in interrupts, so a long fft or redraw handler delays processing (visible
+ * as latency) but never the reads themselves.
+ */
+#define TOUCH_POLL_MS 20
+#define STATS_PERIOD_MS 10000
+void sensorEvent(void);
+void touchEvent(void);
+void fftEvent(void);
+void redrawEvent(void);
+void statsEvent(void);
+Scheduler scheduler;
+SchedulerEvent sensor_event("sensor", 3, SAMPLING_FREQ * 1000, sensorEvent);
+SchedulerEvent touch_event("touch", 2, 50'000, touchEvent);
+SchedulerEvent fft_event("fft", 1, FFT_SIZE * SAMPLING_FREQ * 1000, fftEvent);
+SchedulerEvent redraw_event("redraw", 0, 500'000, redrawEvent);
+SchedulerEvent stats_event("stats", 0, 1'000'000, statsEvent);
+
+// Window being filled, and whether a full one waits for the fft event
+int event_sample_index = 0;
+bool window_pending = false;
+bool have_result = false;
+int event_state = -1;
+
+/* sampleQueued(void)
+ *      Called from the SPI completion interrupt after a sample was queued
+ * @returns None
+ */
+void sampleQueued(void) {
+    scheduler.post(sensor_event);
+}
+/* sensorEvent(void)
+ *      Streams queued samples into the current window. Stops while a full window waits for analysis,
+ *      the samples stay queued until fftEvent() is done with the buffers.
+ * @returns None
+ */
+void sensorEvent(void) {
+    GyroSample block[SAMPLE_BLOCK];
+    while (!window_pending) {
+        uint32_t max = FFT_SIZE - event_sample_index < SAMPLE_BLOCK ? FFT_SIZE - event_sample_index : SAMPLE_BLOCK;
+        uint32_t n = sample_ring.pop(block, max);
+        if (n == 0)
+            return;
+        for (uint32_t k = 0; k < n; k++) {
+            processSample(block[k].xyz, block[k].timestamp_us, event_sample_index++);
+        }
+        if (event_sample_index == FFT_SIZE) {
+            event_sample_index = 0;
+            closeWindow();
+            window_pending = true;
+            scheduler.post(fft_event);
+        }
+    }
+}
+/* fftEvent(void)
+ *      Analyzes the full window for the current screen and releases the buffers for the next one
+ * @returns None
+ */
+void fftEvent(void) {
+    if (gui.state == TREMOR_DETECTION) {
+        analyzeTremor(window_result);
+    } else if (gui.state == FREQ_VIEW) {
+        analyzeSpectrum(window_result);
+    }
+    if ((gui.state == TREMOR_DETECTION || gui.state == FREQ_VIEW) && window_result.changed) {
+        have_result = true;
+        scheduler.post(redraw_event);
+    }
+    window_pending = false;
+    // Catch up on the samples queued meanwhile
+    scheduler.post(sensor_event);
+}
+/* touchEvent(void)
+ *      Polls the touchscreen and the load meter, redraws a newly entered screen right away
+ * @returns None
+ */
+void touchEvent(void) {
+    if (gui.getTouchEvent())
+        gui.update();
+    // A new screen is blank, draw it now and always draw its first window
+    if (gui.state != event_state) {
+        event_state = gui.state;
+        change_detector.reset();
+        scheduler.post(redraw_event);
+    }
+    updateLoad();
+    scheduler.post(touch_event, TOUCH_POLL_MS * 1000);
+}
+/* redrawEvent(void)
+ *      Draws the last result of the current screen
+ * @returns None
+ */
+void redrawEvent(void) {
+    switch(gui.state) {
+        case TREMOR_DETECTION:
+            if (have_result)
+                drawTremor(window_result);
+            break;
+        case FREQ_VIEW:
+            if (have_result)
+                drawSpectrum(window_result);
+            break;
+        case INFO:
+            drawInfo();
+            break;
+    }
+}
+/* statsEvent(void)
+ *      Prints the scheduler statistics of the last period and starts a new one
+ * @returns None
+ */
+void statsEvent(void) {
+    scheduler.printStats();
+    printf("Events: sample ring %lu/%lu overruns %lu, ticks skipped %lu\n", sample_ring.size(),
+           sample_ring.capacity(), sample_ring.overruns(), sample_skips);
+    scheduler.clearStats();
+    scheduler.postAt(stats_event, stats_event.release_us + STATS_PERIOD_MS * 1000);
+}
+#endif
+
+#ifdef TREMOR_COROUTINES
+/************************************
+ * COROUTINE PROFILE
+ * The same pipeline written as sequential coroutines on one stack, resumed by CoRuntime and sleeping
+ * in between. Samples arrive through the interrupt acquisition above:
+ *  | dspTask: co_await sample_block, stream samples, analyze each full window, notify redraw
+ *  | touchPollTask: co_await frame_tick, notify touched on a new touch
+ *  | uiTask: co_await touched, run the menu state machine
+ *  | drawTask: co_await redraw, draw the last result of the current screen
+ * A coroutine runs until its next co_await, so dspTask yields a frame tick before each analysis to let
+ * touch and drawing catch up.
+ */
+#define FRAME_TICK_MS 20
+#define COROUTINE_STATS_WINDOWS 4
+CoRuntime runtime;
+CoEvent sample_block("sample");
+CoEvent frame_tick("frame");
+CoEvent touched("touch");
+CoEvent redraw("redraw");
+Ticker frame_ticker;
+bool co_have_result = false;
+
+/* sampleQueued(void)
+ *      Called from the SPI completion interrupt after a sample was queued
+ * @returns None
+ */
+void sampleQueued(void) {
+    if (sample_ring.size() >= SAMPLE_BLOCK)
+        sample_block.notify();
+}
+/* frameTick(void)
+ *      Ticker interrupt of the UI frame rate
+ * @returns None
+ */
+void frameTick(void) {
+    frame_tick.notify();
+}
+/* dspTask(void)
+ *      Streams sample blocks into the window and analyzes it for the current screen when full
+ * @returns None, never returns
+ */
+CoTask dspTask(void) {
+    GyroSample block[SAMPLE_BLOCK];
+    int i = 0;
+    uint32_t windows = 0;
+    while (true) {
+        co_await sample_block;
+        uint32_t n;
+        while ((n = sample_ring.pop(block, FFT_SIZE - i < SAMPLE_BLOCK ? FFT_SIZE - i : SAMPLE_BLOCK)) > 0) {
+            for (uint32_t k = 0; k < n; k++) {
+                processSample(block[k].xyz, block[k].timestamp_us, i++);
+            }
+            if (i < FFT_SIZE)
+                continue;
+            i = 0;
+            closeWindow();
+
+            co_await frame_tick;
+            if (gui.state == TREMOR_DETECTION) {
+                analyzeTremor(window_result);
+            } else if (gui.state == FREQ_VIEW) {
+                analyzeSpectrum(window_result);
+            }
+            if ((gui.state == TREMOR_DETECTION || gui.state == FREQ_VIEW) && window_result.changed) {
+                co_have_result = true;
+                redraw.notify();
+            }
+            if (++windows % COROUTINE_STATS_WINDOWS == 0) {
+                runtime.printStats();
+                printf("Coroutines: sample ring %lu/%lu overruns %lu, ticks skipped %lu\n", sample_ring.size(),
+                       sample_ring.capacity(), sample_ring.overruns(), sample_skips);
+            }
+        }
+    }
+}
+/* touchPollTask(void)
+ *      Polls the touchscreen and the load meter once per frame
+ * @returns None, never returns
+ */
+CoTask touchPollTask(void) {
+    while (true) {
+        co_await frame_tick;
+        if (gui.getTouchEvent())
+            touched.notify();
+        updateLoad();
+    }
+}
+/* uiTask(void)
+ *      Runs the menu state machine on every touch and redraws a newly entered screen
+ * @returns None, never returns
+ */
+CoTask uiTask(void) {
+    int last_state = gui.state;
+    while (true) {
+        co_await touched;
+        gui.update();
+        // A new screen is blank, draw it now and always draw its first window
+        if (gui.state != last_state) {
+            last_state = gui.state;
+            change_detector.reset();
+            redraw.notify();
+        }
+    }
+}
+/* drawTask(void)
+ *      Draws the last result of the current screen whenever it changed
+ * @returns None, never returns
+ */
+CoTask drawTask(void) {
+    while (true) {
+        co_await redraw;
+        switch(gui.state) {
+            case TREMOR_DETECTION:
+                if (co_have_result)
+                    drawTremor(window_result);
+                break;
+            case FREQ_VIEW:
+                if (co_have_result)
+                    drawSpectrum(window_result);
+                break;
+            case INFO:
+                drawInfo();
+                break;
+        }
+    }
+}
+#endif
+
 /*****************************************
  * MAIN
 ******************************************/
@@ -184,6 +1807,76 @@ int main(void) {
     gui.addState(FREQ_VIEW, FREQ_BUTTON, FREQ_UI);
     gui.addState(INFO, INFO_BUTTON, INFO_UI);
 
+#ifdef TREMOR_RTOS
+    /* Initialize CFFT module */
+    printf("Initializing CFFT\n");
+    arm_cfft_init_256_f32(&fft);
+    CycleCounter::enable();
+    setupDeadlines();
+
+    gui.init();
+    // Touch and drawing only get the CPU the other two threads leave
+    osThreadSetPriority(ThisThread::get_id(), osPriorityBelowNormal);
+    dsp_thread.start(dspTask);
+    acquisition_thread.start(acquisitionTask);
+    uiTask();
+#elif defined(TREMOR_EVENTS)
+    /* Initialize CFFT module */
+    printf("Initializing CFFT\n");
+    arm_cfft_init_256_f32(&fft);
+    CycleCounter::enable();
+    setupDeadlines();
+
+    gui.init();
+    isr_gyro = new Gyroscope();
+    scheduler.add(sensor_event);
+    scheduler.add(touch_event);
+    scheduler.add(fft_event);
+    scheduler.add(redraw_event);
+    scheduler.add(stats_event);
+    scheduler.clearStats();
+    scheduler.post(touch_event);
+    scheduler.post(stats_event, STATS_PERIOD_MS * 1000);
+    sample_ticker.attach(&startSampleRead, std::chrono::milliseconds(SAMPLING_FREQ));
+    scheduler.run();
+#elif defined(TREMOR_COROUTINES)
+    /* Initialize CFFT module */
+    printf("Initializing CFFT\n");
+    arm_cfft_init_256_f32(&fft);
+    CycleCounter::enable();
+    setupDeadlines();
+
+    gui.init();
+    isr_gyro = new Gyroscope();
+    runtime.spawn(dspTask());
+    runtime.spawn(touchPollTask());
+    runtime.spawn(uiTask());
+    runtime.spawn(drawTask());
+    runtime.printStats();
+    frame_ticker.attach(&frameTick, std::chrono::milliseconds(FRAME_TICK_MS));
+    sample_ticker.attach(&startSampleRead, std::chrono::milliseconds(SAMPLING_FREQ));
+    runtime.run();
+#else
+    CycleCounter::enable();
+    setupDeadlines();
+#ifdef CLOCK_GOVERNOR
+    if (!governor.init())
+        printf("Clock: unexpected startup prescalers, governor disabled\n");
+#endif
+#ifdef TREMOR_LOW_POWER
+    fifo_gyro = new Gyroscope();
+#ifdef ADAPTIVE_SAMPLING
+    fifo_gyro->enableFifo(WATCH_WATERMARK);
+    mode_start_us = us_ticker_read();
+#else
+    fifo_gyro->enableFifo(FIFO_WATERMARK);
+#endif
+    fifo_int.rise(&fifoWatermark);
+    // Stop mode would halt the LTDC and the SDRAM refresh that hold the frame buffer, so the core
+    // sleeps (WFI) with the peripherals running
+    sleep_manager_lock_deep_sleep();
+#endif
+
     /* Initialize first FFT Sample with Gyro Data*/
     fillFFTWindow();
 
@@ -193,11 +1886,21 @@ int main(void) {
     status = arm_cfft_init_256_f32(&fft);
 
     gui.init();
+    int last_state = gui.state;
     // Execution //
     while (true) {
         
         if(gui.getTouchEvent())
             gui.update();
+        // No windows are closed on the info screen
+        if (updateLoad() && gui.state == INFO)
+            cpu_load.print();
+
+        // A new screen is blank, always draw its first window
+        if (gui.state != last_state) {
+            change_detector.reset();
+            last_state = gui.state;
+        }
 
         switch(gui.state) {
             case TREMOR_DETECTION: ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -205,56 +1908,11 @@ int main(void) {
                 if(gui.getTouchEvent())
                     gui.update();
 
-                // Perform FFT
-                float freq = fourierTransform();
-                
-                // Apply moving average 
-                moving_avg_freq.update(freq);
-
-                // Draw text with freq
-                char freq_str[8];
-                sprintf(freq_str, "%4.2f", moving_avg_freq.getAverage());
-                gui.lcd.SetBackColor(gui.background_color);
-                gui.lcd.SetTextColor(LCD_COLOR_WHITE);
-                gui.lcd.DisplayStringAt(0, 80, (uint8_t *) " Tremor Range:", LEFT_MODE);
-                //gui.lcd.DisplayStringAt(0, 110, (uint8_t *) "        ", CENTER_MODE);
-                gui.lcd.DisplayStringAt(10, 110, (uint8_t *) "[3.0, 6.0]", LEFT_MODE);
-                gui.lcd.DisplayStringAt(200, 110, (uint8_t *) "hz", LEFT_MODE);
-                
-                // Classify frequency into intensities
-                if(moving_avg_freq.getAverage() >= 5.0f && moving_avg_freq.getAverage() <= 6.0f){
-                    RectRegion r(40, 200, 160, 100, LCD_COLOR_DARKRED, LCD_COLOR_BLACK, 4, LCD_COLOR_ORANGE, "");
-                    r.draw(&(gui.lcd));
-                    gui.lcd.SetBackColor(LCD_COLOR_DARKRED);
-                    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
-                    gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "HIGH", LEFT_MODE);
-                } 
-                else if(moving_avg_freq.getAverage() >= 4.0f && moving_avg_freq.getAverage() < 5.0f){
-                    RectRegion r(40, 200, 160, 100, LCD_COLOR_ORANGE, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
-                    r.draw(&(gui.lcd));
-                    gui.lcd.SetBackColor(LCD_COLOR_ORANGE);
-                    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
-                    gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "MID", LEFT_MODE);
-                } 
-                else if(moving_avg_freq.getAverage() >= 3.0f && moving_avg_freq.getAverage() < 4.0f){
-                    RectRegion r(40, 200, 160, 100, LCD_COLOR_YELLOW, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
-                    r.draw(&(gui.lcd));
-                    gui.lcd.SetBackColor(LCD_COLOR_YELLOW);
-                    gui.lcd.SetTextColor(LCD_COLOR_BLACK);
-                    gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "LOW", LEFT_MODE);
-                } 
-                else {
-                    RectRegion r(40, 200, 160, 100, LCD_COLOR_DARKGREEN, LCD_COLOR_BLACK, 4, LCD_COLOR_DARKYELLOW, "");
-                    r.draw(&(gui.lcd));
-                    gui.lcd.SetBackColor(LCD_COLOR_DARKGREEN);
-                    gui.lcd.SetTextColor(LCD_COLOR_WHITE);
-                    gui.lcd.DisplayStringAt(56, 260, (uint8_t *) "N/A", LEFT_MODE);
+                if (window_filled) {
+                    analyzeTremor(window_result);
+                    if (window_result.changed)
+                        drawTremor(window_result);
                 }
-                gui.lcd.DisplayStringAt(56, 210, (uint8_t *) "Status: ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(0, 234, (uint8_t *) "        ", CENTER_MODE);
-                gui.lcd.DisplayStringAt(56, 234, (uint8_t *)freq_str, LEFT_MODE);
-                gui.lcd.DisplayStringAt(140, 234, (uint8_t *) "hz", LEFT_MODE);
-                gui.lcd.SetTextColor(LCD_COLOR_WHITE);
                 
                 // Get new gyroscope Sample
                 fillFFTWindow();
@@ -267,43 +1925,10 @@ int main(void) {
                     gui.update();
                 
                 // Perform FFT
-                float freq = fourierTransform();
-
-                // Draw text with freq
-                char freq_str[8];
-                sprintf(freq_str, "%4.2f", freq);
-                gui.lcd.SetBackColor(gui.background_color);
-                gui.lcd.SetTextColor(LCD_COLOR_WHITE);
-                gui.lcd.DisplayStringAt(40, 80, (uint8_t *) "Freq:", LEFT_MODE);
-                gui.lcd.DisplayStringAt(0, 110, (uint8_t *) "        ", CENTER_MODE);
-                gui.lcd.DisplayStringAt(40, 110, (uint8_t *) freq_str, LEFT_MODE);
-                gui.lcd.DisplayStringAt(140, 110, (uint8_t *) "hz", LEFT_MODE);
-                
-                // Starting point for Graph
-                int y_max = 100;
-                int y_coord = 300;
-                int x_coord = 56;
-                // Draw Graph
-                for (uint32_t i = 0; i < FFT_SIZE/2; i++) {
-                    int magnitude = y_max * fft_output[i] / fft_maxValue;
-                    if (magnitude > y_max) {
-                        magnitude = y_max;
-                    } else if (magnitude < 0) {
-                        magnitude = 0;
-                    }
-                    
-                    // Clear previous line
-                    gui.lcd.SetTextColor(gui.background_color);
-                    gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - y_max);
-                    
-                    // Draw new line
-                    if (fft_maxIndex == i) {
-                        gui.lcd.SetTextColor(LCD_COLOR_CYAN);
-                        gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - magnitude);
-                    } else {
-                        gui.lcd.SetTextColor(LCD_COLOR_DARKGREEN);
-                        gui.lcd.DrawLine(i+x_coord, y_coord, i+x_coord, y_coord - magnitude);
-                    }
+                if (window_filled) {
+                    analyzeSpectrum(window_result);
+                    if (window_result.changed)
+                        drawSpectrum(window_result);
                 }
 
                 // Sample gyroscope data
@@ -316,29 +1941,11 @@ int main(void) {
                 if(gui.getTouchEvent())
                     gui.update();
                 // Show device info
-                BSP_LCD_SetFont(&Font16);
-                gui.lcd.SetBackColor(gui.background_color);
-                gui.lcd.DisplayStringAt(10, 60, (uint8_t *) "This device collects", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 80, (uint8_t *) "gyroscope data and ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 100, (uint8_t *) "calculates the freq. ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 120, (uint8_t *) "of oscillation to ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 140, (uint8_t *) "detect Parkinsonian ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 160, (uint8_t *) "Tremors. ", LEFT_MODE);
-                gui.lcd.SetBackColor(LCD_COLOR_DARKGRAY);
-                gui.lcd.DisplayStringAt(10, 180, (uint8_t *) "Tremor Mode:", LEFT_MODE);
-                gui.lcd.SetBackColor(gui.background_color);
-                gui.lcd.DisplayStringAt(10, 200, (uint8_t *) "- Processes signal", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 220, (uint8_t *) "- Identifies resting", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 240, (uint8_t *) "tremor + intensity", LEFT_MODE);
-                gui.lcd.SetBackColor(LCD_COLOR_DARKGRAY);
-                gui.lcd.DisplayStringAt(10, 260, (uint8_t *) "Frequency Mode:", LEFT_MODE);
-                gui.lcd.SetBackColor(gui.background_color);
-                gui.lcd.DisplayStringAt(10, 280, (uint8_t *) "- Outputs raw ", LEFT_MODE);
-                gui.lcd.DisplayStringAt(10, 300, (uint8_t *) "frequency spectrum", LEFT_MODE);
-                BSP_LCD_SetFont(&Font24);
+                drawInfo();
             } break; 
                 
         }
     }
+#endif
     return 0;
 }
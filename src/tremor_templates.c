@@ -0,0 +1,45 @@
+// DTW tremor template library for TemplateMatcher, generated by tools/gen_templates.py
+
+#include "arm_math.h"
+
+const uint32_t dtw_template_count = 5;
+const float32_t dtw_template_freqs[] = {3.00f, 4.00f, 5.00f, 6.00f, 1.50f};
+const uint8_t dtw_template_is_tremor[] = {1, 1, 1, 1, 0};
+
+const float32_t dtw_templates[] = {
+    // 3.00 hz
+    -0.07008f, 1.01444f, 1.45603f, 1.16253f, 0.56916f, 0.10817f, -0.21002f, -0.64717f,
+    -1.24135f, -1.59506f, -1.24303f, -0.20495f, 0.91741f, 1.44746f, 1.22019f, 0.63347f,
+    0.14858f, -0.17345f, -0.58749f, -1.17715f, -1.58465f, -1.32231f, -0.33869f, 0.81246f,
+    1.42889f, 1.27335f, 0.69954f, 0.19138f, -0.13823f, -0.53053f, -1.11087f, -1.56547f,
+    -1.39196f, -0.47018f, 0.70036f, 1.40008f, 1.32121f, 0.76689f, 0.23683f, -0.10392f,
+    -0.47643f, -1.04328f, -1.53808f, -1.45163f, -0.59834f, 0.58196f, 1.36094f, 1.36299f,
+    // 4.00 hz
+    -0.05816f, 1.30187f, 1.37330f, 0.59954f, 0.01196f, -0.47623f, -1.26323f, -1.60039f,
+    -0.60166f, 0.95784f, 1.50013f, 0.87300f, 0.16681f, -0.28312f, -0.98931f, -1.61645f,
+    -1.07415f, 0.48535f, 1.48408f, 1.14692f, 0.35992f, -0.12827f, -0.71585f, -1.48961f,
+    -1.41819f, -0.05816f, 1.30187f, 1.37330f, 0.59954f, 0.01196f, -0.47623f, -1.26323f,
+    -1.60039f, -0.60166f, 0.95784f, 1.50013f, 0.87300f, 0.16681f, -0.28312f, -0.98931f,
+    -1.61645f, -1.07415f, 0.48535f, 1.48408f, 1.14692f, 0.35992f, -0.12827f, -0.71585f,
+    // 5.00 hz
+    -0.00887f, 1.48661f, 1.04984f, 0.17245f, -0.42221f, -1.37544f, -1.20202f, 0.65440f,
+    1.53179f, 0.70680f, -0.00887f, -0.72454f, -1.54953f, -0.67214f, 1.18428f, 1.35770f,
+    0.40447f, -0.19019f, -1.06758f, -1.50435f, -0.00887f, 1.48661f, 1.04984f, 0.17245f,
+    -0.42221f, -1.37544f, -1.20202f, 0.65440f, 1.53179f, 0.70680f, -0.00887f, -0.72454f,
+    -1.54953f, -0.67214f, 1.18428f, 1.35770f, 0.40447f, -0.19019f, -1.06758f, -1.50435f,
+    -0.00887f, 1.48661f, 1.04984f, 0.17245f, -0.42221f, -1.37544f, -1.20202f, 0.65440f,
+    // 6.00 hz
+    -0.04763f, 1.43476f, 0.75599f, -0.26088f, -1.31965f, -1.13674f, 0.86317f, 1.31441f,
+    0.27605f, -0.72649f, -1.54357f, -0.29271f, 1.38767f, 0.88101f, -0.15345f, -1.21443f,
+    -1.28534f, 0.65937f, 1.38460f, 0.39038f, -0.60419f, -1.52579f, -0.53064f, 1.30603f,
+    1.00331f, -0.04763f, -1.09856f, -1.40128f, 0.43539f, 1.43054f, 0.50894f, -0.48563f,
+    -1.47985f, -0.75462f, 1.19009f, 1.11918f, 0.05820f, -0.97626f, -1.48293f, 0.19746f,
+    1.44832f, 0.63124f, -0.37130f, -1.40966f, -0.95842f, 1.04149f, 1.22440f, 0.16563f,
+    // 1.50 hz
+    -0.03650f, 0.36799f, 0.74037f, 1.05105f, 1.27536f, 1.39550f, 1.40192f, 1.29411f,
+    1.08063f, 0.77843f, 0.41152f, 0.00904f, -0.39707f, -0.77454f, -1.09340f, -1.32834f,
+    -1.46068f, -1.47993f, -1.38455f, -1.18212f, -0.88871f, -0.52763f, -0.12754f, 0.27977f,
+    0.66197f, 0.98870f, 1.23401f, 1.37843f, 1.41049f, 1.32764f, 1.13645f, 0.85212f,
+    0.49722f, 0.09994f, -0.30818f, -0.69473f, -1.02900f, -1.28446f, -1.44081f, -1.48565f,
+    -1.41540f, -1.23565f, -0.96068f, -0.61231f, -0.21822f, 0.19030f, 0.58081f, 0.92230f,
+};
@@ -0,0 +1,147 @@
+#include <unity.h>
+#include <stdio.h>
+#include <complex>
+#include <utility>
+#include "LombScargle.h"
+
+// Window of the pipeline: 256 samples every 30 ms
+#define WINDOW 256
+#define PERIOD_S 0.03f
+// Peak timing jitter of the test windows (+-2 ms)
+#define JITTER_S 0.004f
+
+/**
+ * The vendored CMSIS-DSP snapshot has no arm_common_tables.c (twiddles, bit reversal tables), so the
+ * CMSIS FFT cannot be linked here. A radix-2 complex FFT with the same interface stands in for it.
+ */
+extern "C" {
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len1024 = {LOMB_FFT_SIZE, nullptr, nullptr, 0};
+
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    // Output is always in natural order
+    (void)bitReverseFlag;
+    const uint32_t n = S->fftLen;
+    std::complex<double> x[LOMB_FFT_SIZE];
+    for (uint32_t i = 0; i < n; i++) {
+        x[i] = {p1[2 * i], p1[2 * i + 1]};
+    }
+    for (uint32_t i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+    for (uint32_t size = 2; size <= n; size <<= 1) {
+        std::complex<double> step = std::polar(1.0, (ifftFlag ? 2.0 : -2.0) * PI / size);
+        for (uint32_t start = 0; start < n; start += size) {
+            std::complex<double> w = 1.0;
+            for (uint32_t k = 0; k < size / 2; k++) {
+                std::complex<double> t = w * x[start + k + size / 2];
+                x[start + k + size / 2] = x[start + k] - t;
+                x[start + k] += t;
+                w *= step;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        p1[2 * i] = x[i].real();
+        p1[2 * i + 1] = x[i].imag();
+    }
+}
+}
+
+/**
+ * Normalized Lomb-Scargle power at one frequency, evaluated directly in double precision.
+ *
+ * @returns double power, normalized by twice the sample variance as in LombScargle
+ */
+static double directPower(const float *times, const float *values, uint32_t n, double hz) {
+    double mean = 0.0;
+    double variance = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        mean += values[i];
+    }
+    mean /= n;
+    for (uint32_t i = 0; i < n; i++) {
+        variance += (values[i] - mean) * (values[i] - mean);
+    }
+    variance /= n - 1;
+
+    const double w = 2.0 * PI * hz;
+    double s2 = 0.0, c2 = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        s2 += sin(2.0 * w * times[i]);
+        c2 += cos(2.0 * w * times[i]);
+    }
+    const double tau = atan2(s2, c2) / (2.0 * w);
+    double yc = 0.0, cc = 0.0, ys = 0.0, ss = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        double c = cos(w * (times[i] - tau));
+        double s = sin(w * (times[i] - tau));
+        yc += (values[i] - mean) * c;
+        cc += c * c;
+        ys += (values[i] - mean) * s;
+        ss += s * s;
+    }
+    return (yc * yc / cc + ys * ys / ss) / (2.0 * variance);
+}
+
+/**
+ * A sine on jittered sample times.
+ *
+ * @returns None
+ */
+static void jitteredSine(float *times, float *values, float hz) {
+    uint32_t seed = 7;
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        times[i] = i * PERIOD_S + ((seed >> 8) / 16777216.0f - 0.5f) * JITTER_S;
+        values[i] = sinf(2.0f * PI * hz * times[i]);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_peak_matches_direct_evaluation(void) {
+    static LombScargle lomb;
+    float times[WINDOW];
+    float values[WINDOW];
+    for (float hz = 2.2f; hz < 8.0f; hz += 0.4f) {
+        jitteredSine(times, values, hz);
+        float peak = lomb.compute(times, values, WINDOW, 2.0f, 8.0f);
+        double reference = directPower(times, values, WINDOW, peak);
+        printf("%.1f hz: peak %.3f hz, power %.2f, direct %.2f, ratio %.4f\n", hz, peak, lomb.peak_power, reference,
+               lomb.peak_power / reference);
+        TEST_ASSERT_FLOAT_WITHIN(lomb.step_hz, hz, peak);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, lomb.peak_power / reference);
+    }
+}
+
+void test_band_matches_direct_evaluation(void) {
+    static LombScargle lomb;
+    float times[WINDOW];
+    float values[WINDOW];
+    // Near the top of the band, where the doubled phase is closest to the grid's nyquist frequency
+    jitteredSine(times, values, 7.8f);
+    lomb.compute(times, values, WINDOW, 2.0f, 8.0f);
+    double reference = directPower(times, values, WINDOW, lomb.peak_hz);
+    double worst = 0.0;
+    for (uint32_t b = 0; b < lomb.num_bins; b++) {
+        double error = fabs(lomb.power[b] - directPower(times, values, WINDOW, lomb.first_hz + b * lomb.step_hz));
+        if (error > worst)
+            worst = error;
+    }
+    printf("2-8 hz, %lu bins: worst error %.4f of the peak power\n", static_cast<unsigned long>(lomb.num_bins),
+           worst / reference);
+    TEST_ASSERT_TRUE(worst < 0.01 * reference);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_peak_matches_direct_evaluation);
+    RUN_TEST(test_band_matches_direct_evaluation);
+    return UNITY_END();
+}
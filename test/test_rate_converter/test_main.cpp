@@ -0,0 +1,80 @@
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include "RateConverter.h"
+
+// Pipeline grid: one sample every 30 ms
+#define GRID_US 30000
+// Seconds of input per tone
+#define DURATION_S 8
+
+/**
+ * Worst interpolation error over one tone, streamed at odr_hz as the FIFO delivers it.
+ *
+ * @returns float largest deviation of a grid sample from the tone at its grid time
+ */
+static float worstError(float odr_hz, float hz) {
+    RateConverter converter(GRID_US);
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < odr_hz * DURATION_S; i++) {
+        uint32_t t_us = 1000 + static_cast<uint32_t>(i * 1e6f / odr_hz);
+        float value = sinf(2.0f * M_PI * hz * t_us * 1e-6f);
+        std::array<float, 3> xyz = {value, value, value};
+        if (converter.update(xyz, t_us) && i > 0) {
+            float error = fabsf(converter.output[0] - sinf(2.0f * M_PI * hz * converter.output_us * 1e-6f));
+            worst = error > worst ? error : worst;
+        }
+    }
+    return worst;
+}
+
+/**
+ * Worst interpolation error over 3-8 hz at one data rate.
+ *
+ * @returns float largest deviation, as a fraction of the amplitude
+ */
+static float worstBandError(float odr_hz) {
+    float worst = 0.0f;
+    for (float hz = 3.0f; hz <= 8.01f; hz += 0.5f) {
+        float error = worstError(odr_hz, hz);
+        worst = error > worst ? error : worst;
+    }
+    return worst;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_error_at_watch_rate(void) {
+    float worst = worstBandError(95.0f);
+    printf("95 hz in: worst error 3-8 hz %.4f\n", worst);
+    TEST_ASSERT_TRUE(worst < 0.04f);
+}
+
+void test_capture_rate_is_more_accurate(void) {
+    float slow = worstBandError(95.0f);
+    float fast = worstBandError(190.0f);
+    printf("190 hz in: worst error 3-8 hz %.4f, %.1fx below 95 hz\n", fast, slow / fast);
+    TEST_ASSERT_TRUE(fast < 0.01f);
+    TEST_ASSERT_TRUE(fast * 3.0f < slow);
+}
+
+void test_gap_is_skipped(void) {
+    RateConverter converter(GRID_US);
+    std::array<float, 3> xyz = {0.0f, 0.0f, 0.0f};
+    converter.update(xyz, 0);
+    converter.update(xyz, 10000);
+    // 100 ms without input, as after a FIFO overrun
+    converter.update(xyz, 110000);
+    TEST_ASSERT_EQUAL_UINT32(3, converter.skipped);
+    TEST_ASSERT_TRUE(converter.update(xyz, 120000));
+    TEST_ASSERT_EQUAL_UINT32(120000, converter.output_us);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_error_at_watch_rate);
+    RUN_TEST(test_capture_rate_is_more_accurate);
+    RUN_TEST(test_gap_is_skipped);
+    return UNITY_END();
+}
@@ -0,0 +1,247 @@
+#include <unity.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "RingBuffer.h"
+
+// Bulk block size of the producer / consumer
+#define STRESS_BLOCK 7
+// The producer waits for room except during the first STRESS_BURST of every STRESS_PERIOD elements,
+// so most elements cross between the threads and every period still overruns the ring
+#define STRESS_PERIOD 4096
+#define STRESS_BURST 256
+// Elements moved per benchmark run, and the block size of the bulk benchmark
+#define BENCH_ELEMENTS 20000000
+#define BENCH_BLOCK 32
+
+/**
+ * @brief Sequence number with a redundant copy, so a torn or stale slot is detected
+ *
+ */
+struct Tagged {
+    uint32_t seq;
+    uint32_t check;
+};
+
+static Tagged tag(uint32_t seq) {
+    return {seq, ~seq * 2654435761u};
+}
+
+static bool intact(const Tagged &t) {
+    return t.check == ~t.seq * 2654435761u;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * Runs a producer and a consumer thread over a ring. The producer pushes elements sequence
+ * numbers alternating single and bulk pushes, in paced stretches and unpaced bursts; the consumer pops
+ * alternating single and bulk pops and checks that what arrives is intact and strictly in order.
+ *
+ * @returns None
+ */
+template <RingOverrun POLICY, uint32_t CAPACITY>
+void stress(uint32_t elements) {
+    static RingBuffer<Tagged, CAPACITY, POLICY> ring;
+    std::atomic<bool> done{false};
+    uint32_t pushed = 0;
+    uint32_t accepted = 0;
+
+    std::thread producer([&]() {
+        Tagged block[STRESS_BLOCK];
+        while (pushed < elements) {
+            // Sleeping rather than yielding lets the consumer run on a single core host
+            if (pushed % STRESS_PERIOD >= STRESS_BURST) {
+                while (ring.size() > CAPACITY / 2) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                }
+            }
+            if (pushed % 2 == 0) {
+                accepted += ring.push(tag(pushed)) ? 1 : 0;
+                pushed++;
+            } else {
+                uint32_t n = elements - pushed < STRESS_BLOCK ? elements - pushed : STRESS_BLOCK;
+                for (uint32_t i = 0; i < n; i++) {
+                    block[i] = tag(pushed + i);
+                }
+                accepted += ring.push(block, n);
+                pushed += n;
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t received = 0;
+    uint32_t corrupted = 0;
+    uint32_t out_of_order = 0;
+    int64_t last = -1;
+    Tagged block[STRESS_BLOCK];
+    bool bulk = false;
+    while (true) {
+        // Read done before popping, so an empty pop after it means everything was consumed
+        bool finished = done.load(std::memory_order_acquire);
+        uint32_t n = bulk ? ring.pop(block, STRESS_BLOCK) : (ring.pop(block[0]) ? 1 : 0);
+        bulk = !bulk;
+        for (uint32_t i = 0; i < n; i++) {
+            if (!intact(block[i]))
+                corrupted++;
+            if (static_cast<int64_t>(block[i].seq) <= last)
+                out_of_order++;
+            last = block[i].seq;
+        }
+        received += n;
+        if (n == 0 && finished)
+            break;
+    }
+    producer.join();
+
+    printf("%s capacity %u: pushed %u accepted %u received %u lost %u\n",
+           POLICY == RING_DROP_NEWEST ? "drop newest" : "overwrite oldest", CAPACITY, pushed, accepted,
+           received, ring.overruns());
+    TEST_ASSERT_EQUAL_UINT32(0, corrupted);
+    TEST_ASSERT_EQUAL_UINT32(0, out_of_order);
+    TEST_ASSERT_TRUE(ring.empty());
+    // Both paths were exercised: elements crossed between the threads and some were lost (a bulk push
+    // larger than a small ring always loses part of the block)
+    TEST_ASSERT_TRUE(received > elements / 4);
+    TEST_ASSERT_TRUE(ring.overruns() > 0);
+    if (POLICY == RING_DROP_NEWEST) {
+        TEST_ASSERT_EQUAL_UINT32(accepted, received);
+        TEST_ASSERT_EQUAL_UINT32(pushed, accepted + ring.overruns());
+    } else {
+        TEST_ASSERT_EQUAL_UINT32(pushed, accepted);
+        TEST_ASSERT_EQUAL_UINT32(pushed, received + ring.overruns());
+    }
+}
+
+void test_drop_newest_two_threads(void) {
+    stress<RING_DROP_NEWEST, 64>(1000000);
+}
+
+void test_drop_newest_small_ring_two_threads(void) {
+    stress<RING_DROP_NEWEST, 4>(100000);
+}
+
+void test_overwrite_oldest_two_threads(void) {
+    stress<RING_OVERWRITE_OLDEST, 64>(1000000);
+}
+
+void test_overwrite_oldest_small_ring_two_threads(void) {
+    stress<RING_OVERWRITE_OLDEST, 4>(100000);
+}
+
+void test_drop_newest_rejects_when_full(void) {
+    RingBuffer<uint32_t, 8> ring;
+    uint32_t values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    TEST_ASSERT_EQUAL_UINT32(8, ring.push(values, 10));
+    TEST_ASSERT_FALSE(ring.push(values[9]));
+    TEST_ASSERT_EQUAL_UINT32(3, ring.overruns());
+
+    uint32_t out[8];
+    TEST_ASSERT_EQUAL_UINT32(8, ring.pop(out, 8));
+    for (uint32_t i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, out[i]);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_overwrite_oldest_keeps_newest(void) {
+    RingBuffer<uint32_t, 8, RING_OVERWRITE_OLDEST> ring;
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    // The slot at head - CAPACITY may be mid-write, so one less than the capacity survives a lap
+    uint32_t out[8];
+    uint32_t n = ring.pop(out, 8);
+    TEST_ASSERT_EQUAL_UINT32(7, n);
+    for (uint32_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT32(13 + i, out[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(13, ring.overruns());
+}
+
+void test_spans_wrap_around(void) {
+    RingBuffer<uint32_t, 8> ring;
+    uint32_t out[8];
+    uint32_t values[6] = {0, 1, 2, 3, 4, 5};
+    ring.push(values, 6);
+    ring.pop(out, 6);
+
+    // Head and tail at 6: the free run ends at the end of the storage
+    uint32_t n;
+    uint32_t *write = ring.writeSpan(n);
+    TEST_ASSERT_EQUAL_UINT32(2, n);
+    write[0] = 100;
+    write[1] = 101;
+    ring.commitWrite(2);
+    write = ring.writeSpan(n);
+    TEST_ASSERT_EQUAL_UINT32(6, n);
+    write[0] = 102;
+    ring.commitWrite(1);
+
+    const uint32_t *read = ring.readSpan(n);
+    TEST_ASSERT_EQUAL_UINT32(2, n);
+    TEST_ASSERT_EQUAL_UINT32(100, read[0]);
+    TEST_ASSERT_EQUAL_UINT32(101, read[1]);
+    ring.commitRead(2);
+    read = ring.readSpan(n);
+    TEST_ASSERT_EQUAL_UINT32(1, n);
+    TEST_ASSERT_EQUAL_UINT32(102, read[0]);
+    ring.commitRead(1);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+volatile uint32_t bench_sink;
+
+/**
+ * Moves BENCH_ELEMENTS through a ring on one thread, block elements per push / pop.
+ *
+ * @returns double million elements per second
+ */
+static double throughput(uint32_t block) {
+    static RingBuffer<uint32_t, 64> ring;
+    uint32_t in[BENCH_BLOCK];
+    uint32_t out[BENCH_BLOCK];
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH_BLOCK; i++) {
+        in[i] = i;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t moved = 0; moved < BENCH_ELEMENTS; moved += block) {
+        if (block == 1) {
+            ring.push(in[moved % BENCH_BLOCK]);
+            ring.pop(out[0]);
+        } else {
+            ring.push(in, block);
+            ring.pop(out, block);
+        }
+        sum += out[0];
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Keeps the loop from being optimized away
+    bench_sink = sum;
+    return BENCH_ELEMENTS / seconds * 1e-6;
+}
+
+void test_benchmark_single_vs_bulk(void) {
+    double single = throughput(1);
+    double bulk = throughput(BENCH_BLOCK);
+    printf("throughput: single %.0f M elements/s, bulk (%u) %.0f M elements/s, %.1fx\n", single, BENCH_BLOCK,
+           bulk, bulk / single);
+    TEST_ASSERT_TRUE(single > 0.0 && bulk > 0.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_drop_newest_rejects_when_full);
+    RUN_TEST(test_overwrite_oldest_keeps_newest);
+    RUN_TEST(test_spans_wrap_around);
+    RUN_TEST(test_drop_newest_two_threads);
+    RUN_TEST(test_drop_newest_small_ring_two_threads);
+    RUN_TEST(test_overwrite_oldest_two_threads);
+    RUN_TEST(test_overwrite_oldest_small_ring_two_threads);
+    RUN_TEST(test_benchmark_single_vs_bulk);
+    return UNITY_END();
+}
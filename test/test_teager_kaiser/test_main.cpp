@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <complex>
+#include "TeagerKaiser.h"
+
+// Window of the pipeline: 256 samples at 33.3 hz
+#define WINDOW 256
+#define RATE_HZ (1000.0f / 30)
+// Windows per timing run
+#define BENCH_WINDOWS 20000
+
+/**
+ * @brief 256-point radix-2 complex FFT with precomputed twiddles, magnitude and peak search: the work of
+ *  arm_cfft_f32 + arm_cmplx_mag_f32 + arm_max_f32 in fourierTransform(). The vendored CMSIS-DSP snapshot
+ *  has no arm_common_tables.c (twiddles, bit reversal tables), so the CMSIS FFT cannot be linked here.
+ */
+class ReferenceFft {
+private:
+    std::complex<float> twiddle[WINDOW / 2];
+    uint16_t reversed[WINDOW];
+
+public:
+    float magnitude[WINDOW];
+
+    ReferenceFft() {
+        for (uint32_t k = 0; k < WINDOW / 2; k++) {
+            twiddle[k] = std::polar(1.0f, -2.0f * PI * k / WINDOW);
+        }
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            uint32_t r = 0;
+            for (uint32_t b = 1, m = WINDOW >> 1; m > 0; b <<= 1, m >>= 1) {
+                if (i & b)
+                    r |= m;
+            }
+            reversed[i] = r;
+        }
+    }
+
+    /**
+     * Transforms a real window and finds the peak bin of the magnitude spectrum (DC excluded).
+     *
+     * @returns uint32_t index of the peak bin
+     */
+    uint32_t peak(const float *samples) {
+        std::complex<float> x[WINDOW];
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            x[reversed[i]] = samples[i];
+        }
+        for (uint32_t size = 2; size <= WINDOW; size <<= 1) {
+            uint32_t step = WINDOW / size;
+            for (uint32_t start = 0; start < WINDOW; start += size) {
+                for (uint32_t k = 0; k < size / 2; k++) {
+                    std::complex<float> t = twiddle[k * step] * x[start + k + size / 2];
+                    x[start + k + size / 2] = x[start + k] - t;
+                    x[start + k] += t;
+                }
+            }
+        }
+        uint32_t best = 1;
+        for (uint32_t i = 1; i < WINDOW / 2; i++) {
+            magnitude[i] = std::abs(x[i]);
+            if (magnitude[i] > magnitude[best])
+                best = i;
+        }
+        return best;
+    }
+};
+
+volatile float bench_sink;
+
+/**
+ * A tremor-like window as the band-pass hands it to the tracker: a sine with slow amplitude
+ * modulation and a little noise.
+ *
+ * @returns None
+ */
+static void tremor(float *samples, float hz, float noise) {
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float n = noise * ((seed >> 8) / 16777216.0f - 0.5f);
+        float envelope = 1.0f + 0.2f * sinf(2.0f * PI * 0.3f * i / RATE_HZ);
+        samples[i] = envelope * sinf(2.0f * PI * hz * i / RATE_HZ) + n;
+    }
+}
+
+/**
+ * Window estimate of the tracker, streamed sample by sample as in processSample().
+ *
+ * @returns float frequency in hz
+ */
+static float streamWindow(TeagerKaiser &tkeo, const float *samples) {
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        tkeo.update(samples[i]);
+    }
+    return tkeo.endWindow();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_accuracy_against_fft(void) {
+    float samples[WINDOW];
+    ReferenceFft fft;
+    float worst_tkeo = 0.0f;
+    float worst_fft = 0.0f;
+    for (float hz = 2.5f; hz <= 7.01f; hz += 0.25f) {
+        tremor(samples, hz, 0.05f);
+        TeagerKaiser tkeo(RATE_HZ);
+        float tkeo_hz = streamWindow(tkeo, samples);
+        float fft_hz = fft.peak(samples) * (RATE_HZ / WINDOW);
+        worst_tkeo = fabsf(tkeo_hz - hz) > worst_tkeo ? fabsf(tkeo_hz - hz) : worst_tkeo;
+        worst_fft = fabsf(fft_hz - hz) > worst_fft ? fabsf(fft_hz - hz) : worst_fft;
+    }
+    printf("2.5-7 hz with noise: worst error tkeo %.4f hz, fft peak %.4f hz (bin %.3f hz)\n", worst_tkeo, worst_fft,
+           RATE_HZ / WINDOW);
+    TEST_ASSERT_TRUE(worst_tkeo < 0.05f);
+    TEST_ASSERT_TRUE(worst_fft <= 0.5f * RATE_HZ / WINDOW + 1e-3f);
+}
+
+void test_noise_sensitivity(void) {
+    float samples[WINDOW];
+    const float noise[3] = {0.1f, 0.3f, 0.6f};
+    for (uint32_t i = 0; i < 3; i++) {
+        tremor(samples, 4.5f, noise[i]);
+        TeagerKaiser tkeo(RATE_HZ);
+        printf("4.5 hz, noise %.1f p-p: tkeo %.3f hz\n", noise[i], streamWindow(tkeo, samples));
+    }
+    // The energy operator weighs noise by frequency, so broadband noise pulls the estimate upwards;
+    // the firmware's 2-8 hz band-pass keeps that in check
+    tremor(samples, 4.5f, 0.1f);
+    TeagerKaiser tkeo(RATE_HZ);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.5f, streamWindow(tkeo, samples));
+}
+
+void test_benchmark_against_fft(void) {
+    float samples[WINDOW];
+    tremor(samples, 4.5f, 0.05f);
+    TeagerKaiser tkeo(RATE_HZ);
+    ReferenceFft fft;
+    float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < BENCH_WINDOWS; w++) {
+        sink += fft.peak(samples) * (RATE_HZ / WINDOW);
+    }
+    double fft_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < BENCH_WINDOWS; w++) {
+        sink += streamWindow(tkeo, samples);
+    }
+    double tkeo_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    bench_sink = sink;
+
+    printf("per window: fft path %.0f ns, tkeo %.0f ns (%.1f ns/sample), fft/tkeo %.1fx\n", fft_ns / BENCH_WINDOWS,
+           tkeo_ns / BENCH_WINDOWS, tkeo_ns / BENCH_WINDOWS / WINDOW, fft_ns / tkeo_ns);
+    TEST_ASSERT_TRUE(fft_ns > 0.0 && tkeo_ns > 0.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_accuracy_against_fft);
+    RUN_TEST(test_noise_sensitivity);
+    RUN_TEST(test_benchmark_against_fft);
+    return UNITY_END();
+}
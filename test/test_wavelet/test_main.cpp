@@ -0,0 +1,181 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <complex>
+#include "Wavelet.h"
+
+// Window of the pipeline: 256 samples at 33.3 hz
+#define WINDOW 256
+#define RATE_HZ (1000.0f / 30)
+// Windows per timing run
+#define BENCH_WINDOWS 20000
+
+/**
+ * @brief 256-point radix-2 complex FFT with precomputed twiddles, magnitude and peak search: the work of
+ *  arm_cfft_f32 + arm_cmplx_mag_f32 + arm_max_f32 in fourierTransform(). The vendored CMSIS-DSP snapshot
+ *  has no arm_common_tables.c (twiddles, bit reversal tables), so the CMSIS FFT cannot be linked here.
+ */
+class ReferenceFft {
+private:
+    std::complex<float> twiddle[WINDOW / 2];
+    uint16_t reversed[WINDOW];
+
+public:
+    float magnitude[WINDOW];
+
+    ReferenceFft() {
+        for (uint32_t k = 0; k < WINDOW / 2; k++) {
+            twiddle[k] = std::polar(1.0f, -2.0f * PI * k / WINDOW);
+        }
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            uint32_t r = 0;
+            for (uint32_t b = 1, m = WINDOW >> 1; m > 0; b <<= 1, m >>= 1) {
+                if (i & b)
+                    r |= m;
+            }
+            reversed[i] = r;
+        }
+    }
+
+    /**
+     * Transforms a real window and finds the peak bin of the magnitude spectrum.
+     *
+     * @returns uint32_t index of the peak bin
+     */
+    uint32_t peak(const float *samples) {
+        std::complex<float> x[WINDOW];
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            x[reversed[i]] = samples[i];
+        }
+        for (uint32_t size = 2; size <= WINDOW; size <<= 1) {
+            uint32_t step = WINDOW / size;
+            for (uint32_t start = 0; start < WINDOW; start += size) {
+                for (uint32_t k = 0; k < size / 2; k++) {
+                    std::complex<float> t = twiddle[k * step] * x[start + k + size / 2];
+                    x[start + k + size / 2] = x[start + k] - t;
+                    x[start + k] += t;
+                }
+            }
+        }
+        uint32_t best = 0;
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            magnitude[i] = std::abs(x[i]);
+            if (magnitude[i] > magnitude[best])
+                best = i;
+        }
+        return best;
+    }
+};
+
+volatile float bench_sink;
+
+static void sine(float *samples, float hz, float noise) {
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float n = noise * ((seed >> 8) / 16777216.0f - 0.5f);
+        samples[i] = sinf(2.0f * PI * hz * i / RATE_HZ) + n;
+    }
+}
+
+/**
+ * Band energies of one window streamed sample by sample, as in processSample().
+ *
+ * @returns None
+ */
+static void streamWindow(Wavelet &wavelet, const float *samples) {
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        wavelet.update(samples[i]);
+    }
+    wavelet.endWindow();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tremor_band_energy(void) {
+    float samples[WINDOW];
+    const float hz[2] = {3.6f, 5.0f};
+    for (uint32_t i = 0; i < 2; i++) {
+        Wavelet wavelet(RATE_HZ);
+        sine(samples, hz[i], 0.0f);
+        streamWindow(wavelet, samples);
+        printf("%.1f hz: 3.1-6.3 hz fraction %.3f, dominant %.2f hz\n", hz[i], wavelet.bandFraction(3.0f, 6.3f),
+               wavelet.dominantFrequency(2.0f, 8.4f));
+        // The short CDF 9/7 filters leak ~10% into the neighbouring bands
+        TEST_ASSERT_GREATER_THAN_FLOAT(0.85f, wavelet.bandFraction(3.0f, 6.3f));
+    }
+}
+
+void test_out_of_band_leakage(void) {
+    float samples[WINDOW];
+    Wavelet wavelet(RATE_HZ);
+    sine(samples, 12.0f, 0.0f);
+    streamWindow(wavelet, samples);
+    printf("12 hz: 3.1-6.3 hz fraction %.3f\n", wavelet.bandFraction(3.0f, 6.3f));
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, wavelet.bandFraction(3.0f, 6.3f));
+}
+
+void test_in_place_matches_streaming(void) {
+    float samples[WINDOW];
+    sine(samples, 4.5f, 0.5f);
+    Wavelet streamed(RATE_HZ);
+    streamWindow(streamed, samples);
+    Wavelet in_place(RATE_HZ);
+    for (uint32_t b = 0; b < WINDOW; b += WAVELET_BLOCK) {
+        in_place.transform(samples + b);
+    }
+    in_place.endWindow();
+    for (uint32_t b = 0; b < WAVELET_BANDS; b++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f * streamed.band_energy[b] + 1e-9f, streamed.band_energy[b], in_place.band_energy[b]);
+    }
+}
+
+void test_benchmark_against_fft(void) {
+    float samples[WINDOW];
+    float scratch[WINDOW];
+    sine(samples, 4.5f, 0.5f);
+    Wavelet wavelet(RATE_HZ);
+    ReferenceFft fft;
+    float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < BENCH_WINDOWS; w++) {
+        sink += fft.peak(samples) * (RATE_HZ / WINDOW);
+    }
+    double fft_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < BENCH_WINDOWS; w++) {
+        streamWindow(wavelet, samples);
+        sink += wavelet.dominantFrequency(2.0f, 8.4f);
+    }
+    double stream_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < BENCH_WINDOWS; w++) {
+        memcpy(scratch, samples, sizeof(scratch));
+        for (uint32_t b = 0; b < WINDOW; b += WAVELET_BLOCK) {
+            wavelet.transform(scratch + b);
+        }
+        wavelet.endWindow();
+        sink += wavelet.dominantFrequency(2.0f, 8.4f);
+    }
+    double in_place_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    bench_sink = sink;
+
+    printf("per window: fft path %.0f ns, wavelet streamed %.0f ns, wavelet in place %.0f ns (incl. refill), fft/wavelet %.1fx\n",
+           fft_ns / BENCH_WINDOWS, stream_ns / BENCH_WINDOWS, in_place_ns / BENCH_WINDOWS, fft_ns / stream_ns);
+    printf("fft peak %.2f hz, wavelet dominant %.2f hz\n", fft.peak(samples) * (RATE_HZ / WINDOW),
+           wavelet.dominantFrequency(2.0f, 8.4f));
+    TEST_ASSERT_FLOAT_WITHIN(RATE_HZ / WINDOW, 4.5f, fft.peak(samples) * (RATE_HZ / WINDOW));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tremor_band_energy);
+    RUN_TEST(test_out_of_band_leakage);
+    RUN_TEST(test_in_place_matches_streaming);
+    RUN_TEST(test_benchmark_against_fft);
+    return UNITY_END();
+}
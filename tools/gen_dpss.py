@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+Generates the flash-resident DPSS (Slepian) taper tables (src/dpss_tapers.c) used by
+lib/Multitaper.
+
+The tapers are the eigenvectors of the symmetric tridiagonal matrix that commutes with the
+time-limiting / band-limiting operator (Percival & Walden, ch. 8):
+    diag[n]  = ((N - 1 - 2n) / 2)^2 cos(2 pi W)
+    off[n]   = n (N - n) / 2
+The K largest eigenvalues are located by Sturm bisection, the eigenvectors by inverse
+iteration. Each taper is normalized to unit energy; even tapers have a positive sum, odd
+tapers a positive first moment. The concentration ratios lambda_k, needed for the adaptive
+weighting, are computed from the taper autocorrelation.
+
+Usage:
+    python3 tools/gen_dpss.py -o src/dpss_tapers.c
+"""
+
+import argparse
+import math
+
+# Keep in sync with lib/Multitaper/Multitaper.h
+MULTITAPER_SIZE = 256
+MULTITAPER_TAPERS = 4
+TIME_BANDWIDTH = 2.5  # NW, K <= 2 NW - 1
+
+
+def tridiagonal(n, w):
+    diag = [((n - 1 - 2 * i) / 2.0) ** 2 * math.cos(2.0 * math.pi * w) for i in range(n)]
+    off = [i * (n - i) / 2.0 for i in range(1, n)]
+    return diag, off
+
+
+def count_below(diag, off, x):
+    """Number of eigenvalues smaller than x (Sturm sequence)."""
+    count = 0
+    q = diag[0] - x
+    if q < 0:
+        count += 1
+    for i in range(1, len(diag)):
+        if q == 0:
+            q = 1e-30
+        q = diag[i] - x - off[i - 1] ** 2 / q
+        if q < 0:
+            count += 1
+    return count
+
+
+def eigenvalue(diag, off, index):
+    """index-th smallest eigenvalue by bisection over the Gershgorin interval."""
+    lo = min(diag[i] - (abs(off[i - 1]) if i > 0 else 0) - (abs(off[i]) if i < len(off) else 0) for i in range(len(diag)))
+    hi = max(diag[i] + (abs(off[i - 1]) if i > 0 else 0) + (abs(off[i]) if i < len(off) else 0) for i in range(len(diag)))
+    for _ in range(200):
+        mid = 0.5 * (lo + hi)
+        if count_below(diag, off, mid) > index:
+            hi = mid
+        else:
+            lo = mid
+    return 0.5 * (lo + hi)
+
+
+def inverse_iteration(diag, off, shift):
+    """Eigenvector for the eigenvalue closest to shift (Thomas algorithm solves)."""
+    n = len(diag)
+    # Ramp start: has a component along both the symmetric and the antisymmetric eigenvectors
+    v = [(i + 1.0) / n for i in range(n)]
+    for _ in range(6):
+        a = [0.0] + off
+        b = [d - shift for d in diag]
+        c = off + [0.0]
+        cp = [0.0] * n
+        dp = [0.0] * n
+        cp[0] = c[0] / b[0]
+        dp[0] = v[0] / b[0]
+        for i in range(1, n):
+            m = b[i] - a[i] * cp[i - 1]
+            if m == 0:
+                m = 1e-30
+            cp[i] = c[i] / m
+            dp[i] = (v[i] - a[i] * dp[i - 1]) / m
+        x = [0.0] * n
+        x[-1] = dp[-1]
+        for i in range(n - 2, -1, -1):
+            x[i] = dp[i] - cp[i] * x[i + 1]
+        norm = math.sqrt(sum(t * t for t in x))
+        v = [t / norm for t in x]
+    return v
+
+
+def concentration(v, w):
+    """Fraction of the taper energy inside [-W, W]."""
+    n = len(v)
+    total = 0.0
+    for lag in range(-(n - 1), n):
+        r = sum(v[i] * v[i + lag] for i in range(max(0, -lag), min(n, n - lag)))
+        kernel = 2.0 * w if lag == 0 else math.sin(2.0 * math.pi * w * lag) / (math.pi * lag)
+        total += r * kernel
+    return total
+
+
+def dpss(n, nw, k):
+    w = nw / n
+    diag, off = tridiagonal(n, w)
+    tapers = []
+    for order in range(k):
+        value = eigenvalue(diag, off, n - 1 - order)
+        v = inverse_iteration(diag, off, value + 1e-6 * abs(value))
+        if order % 2 == 0:
+            sign = 1.0 if sum(v) >= 0 else -1.0
+        else:
+            sign = 1.0 if sum((n - 1 - 2 * i) * t for i, t in enumerate(v)) >= 0 else -1.0
+        tapers.append([sign * t for t in v])
+    return tapers, [concentration(v, w) for v in tapers]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", default="src/dpss_tapers.c")
+    args = parser.parse_args()
+
+    tapers, ratios = dpss(MULTITAPER_SIZE, TIME_BANDWIDTH, MULTITAPER_TAPERS)
+    with open(args.output, "w") as f:
+        f.write("// DPSS tapers for Multitaper (N = %d, NW = %.1f, K = %d), generated by tools/gen_dpss.py\n\n"
+                % (MULTITAPER_SIZE, TIME_BANDWIDTH, MULTITAPER_TAPERS))
+        f.write('#include "arm_math.h"\n\n')
+        f.write("const float32_t dpss_eigenvalues[] = {%s};\n\n" % ", ".join("%.8ff" % r for r in ratios))
+        f.write("const float32_t dpss_tapers[] = {\n")
+        for order, values in enumerate(tapers):
+            f.write("    // taper %d, lambda %.8f\n" % (order, ratios[order]))
+            for i in range(0, len(values), 8):
+                f.write("    %s,\n" % ", ".join("%.7ef" % v for v in values[i:i + 8]))
+        f.write("};\n")
+    print("wrote " + args.output)
+
+
+if __name__ == "__main__":
+    main()
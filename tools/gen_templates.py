@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""
+Generates the flash-resident DTW template library (src/tremor_templates.c) used by
+lib/TemplateMatcher.
+
+Each template is DTW_TEMPLATE_LEN samples at the gyroscope sampling rate, starting on a
+rising zero crossing and normalized to zero mean / unit RMS, the same way the matcher
+prepares its query. Rest tremor is modelled as a fundamental with a weaker second
+harmonic; a slow 1.5 hz sway is included as a non-tremor reference.
+
+Usage:
+    python3 tools/gen_templates.py -o src/tremor_templates.c
+"""
+
+import argparse
+import math
+
+# Keep in sync with src/main.cpp and lib/TemplateMatcher/TemplateMatcher.h
+SAMPLE_RATE_HZ = 1000.0 / 30
+DTW_TEMPLATE_LEN = 48
+
+# (frequency hz, second harmonic ratio, is tremor)
+TEMPLATES = [
+    (3.0, 0.3, 1),
+    (4.0, 0.3, 1),
+    (5.0, 0.3, 1),
+    (6.0, 0.2, 1),
+    (1.5, 0.0, 0),
+]
+
+
+def template(freq, harmonic):
+    w = 2.0 * math.pi * freq / SAMPLE_RATE_HZ
+    x = [math.sin(w * n) + harmonic * math.sin(2.0 * w * n) for n in range(DTW_TEMPLATE_LEN)]
+    mean = sum(x) / len(x)
+    x = [v - mean for v in x]
+    rms = math.sqrt(sum(v * v for v in x) / len(x))
+    return [v / rms for v in x]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", default="src/tremor_templates.c")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as f:
+        f.write("// DTW tremor template library for TemplateMatcher, generated by tools/gen_templates.py\n\n")
+        f.write('#include "arm_math.h"\n\n')
+        f.write("const uint32_t dtw_template_count = %d;\n" % len(TEMPLATES))
+        f.write("const float32_t dtw_template_freqs[] = {%s};\n" % ", ".join("%.2ff" % t[0] for t in TEMPLATES))
+        f.write("const uint8_t dtw_template_is_tremor[] = {%s};\n\n" % ", ".join(str(t[2]) for t in TEMPLATES))
+        f.write("const float32_t dtw_templates[] = {\n")
+        for freq, harmonic, _ in TEMPLATES:
+            values = template(freq, harmonic)
+            f.write("    // %.2f hz\n" % freq)
+            for i in range(0, len(values), 8):
+                f.write("    %s,\n" % ", ".join("%.5ff" % v for v in values[i:i + 8]))
+        f.write("};\n")
+    print("wrote " + args.output)
+
+
+if __name__ == "__main__":
+    main()
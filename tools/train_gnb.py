@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Host trainer for the Gaussian naive Bayes tremor classifier (lib/TremorClassifier).
+
+Reads serial captures of the firmware, which prints the feature vector of every classified
+window as "Features: <f0> <f1> ..." (logFeatures() in src/main.cpp, computed on the device by
+extractTremorFeatures()), and writes per-class means, variances and priors as static tables
+to src/gnb_model.c.
+
+Usage:
+    python3 tools/train_gnb.py --quiet rest.txt --voluntary waving.txt \
+        --tremor devttyusbmodem403_*.txt -o src/gnb_model.c
+
+Only the Python standard library is needed.
+"""
+
+import argparse
+import re
+
+# Keep in sync with lib/TremorClassifier/TremorClassifier.h (cepstra 1 .. EMBEDDING_SIZE - 1)
+FEATURE_NAMES = ["peak hz", "tremor band", "low band", "log energy"] + ["c%d" % k for k in range(1, 12)]
+CLASSES = ["quiet", "voluntary", "tremor"]
+EPSILON = 1e-4
+
+LINE = re.compile(r"^Features:((?:\s+-?\d+\.\d+)+)\s*$")
+
+
+def read_vectors(path):
+    """Collects the feature vectors of a capture, dropping corrupted or truncated lines."""
+    vectors = []
+    with open(path, errors="ignore") as f:
+        for line in f:
+            m = LINE.match(line)
+            if not m:
+                continue
+            values = [float(v) for v in m.group(1).split()]
+            if len(values) == len(FEATURE_NAMES):
+                vectors.append(values)
+    return vectors
+
+
+def fit(vectors):
+    dims = len(vectors[0])
+    mean = [sum(v[d] for v in vectors) / len(vectors) for d in range(dims)]
+    var = [sum((v[d] - mean[d]) ** 2 for v in vectors) / len(vectors) for d in range(dims)]
+    return mean, var
+
+
+def c_array(values):
+    return ", ".join("%.6ff" % v for v in values)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    for name in CLASSES:
+        parser.add_argument("--" + name, nargs="+", required=True, help="captures labelled " + name)
+    parser.add_argument("-o", "--output", default="src/gnb_model.c")
+    args = parser.parse_args()
+
+    theta, sigma, counts = [], [], []
+    for name in CLASSES:
+        vectors = []
+        for path in getattr(args, name):
+            vectors += read_vectors(path)
+        if not vectors:
+            parser.error("no Features: lines found for class " + name)
+        mean, var = fit(vectors)
+        theta.append(mean)
+        sigma.append(var)
+        counts.append(len(vectors))
+        print("%-10s %3d windows  mean %s" % (name, len(vectors), ["%.3f" % m for m in mean]))
+
+    priors = [c / float(sum(counts)) for c in counts]
+    with open(args.output, "w") as f:
+        f.write("// Gaussian naive Bayes tables for TremorClassifier, generated by tools/train_gnb.py\n")
+        f.write("// Classes: quiet, voluntary, rest tremor. Features: %s .. %s\n\n"
+                % (", ".join(FEATURE_NAMES[:5]), FEATURE_NAMES[-1]))
+        f.write('#include "arm_math.h"\n\n')
+        f.write("const float32_t gnb_theta[] = {\n")
+        f.write("".join("    %s,\n" % c_array(t) for t in theta))
+        f.write("};\n\n")
+        f.write("const float32_t gnb_sigma[] = {\n")
+        f.write("".join("    %s,\n" % c_array(s) for s in sigma))
+        f.write("};\n\n")
+        f.write("const float32_t gnb_priors[] = {%s};\n\n" % c_array(priors))
+        f.write("const float32_t gnb_epsilon = %.6ff;\n" % EPSILON)
+    print("wrote " + args.output)
+
+
+if __name__ == "__main__":
+    main()